@@ -103,6 +103,15 @@ int main(int, char **)
     // Create ImGui Console
     ImGuiConsole console;
 
+    // Second view over the same log, only showing warnings and errors
+    ImGuiConsole errors(console.SharedSystem(), "imgui-console errors");
+    for (auto type : {csys::ItemType::COMMAND, csys::ItemType::LOG, csys::ItemType::INFO})
+        errors.ShowType(type, false);
+
+    // Filter through a search index instead of scanning every item, and show repeated lines once, as "(xN)"
+    console.System().Logger().EnableSearchIndex(true);
+    console.System().Logger().CollapseDuplicates(true);
+
     // Register variables
     console.System().RegisterVariable("background_color", clear_color, imvec4_setter);
 
@@ -130,6 +139,7 @@ int main(int, char **)
     console.System().Log(csys::ItemType::INFO) << "\tbackground_color - set: [int int int int]" << csys::endl;
     console.System().Log(csys::ItemType::INFO) << csys::endl << "Try running the following command:" << csys::endl;
     console.System().Log(csys::ItemType::INFO) << "\tset background_color [255 0 0 255]" << csys::endl << csys::endl;
+    console.System().Log(csys::ItemType::INFO, CSYS_FMT("Current {}, alpha {:.2f}\n"), clear_color, clear_color.w);
 
     ///////////////////////////////////////////////////////////////////////////
 
@@ -146,6 +156,7 @@ int main(int, char **)
 
         // ImGui Console
         console.Draw();
+        errors.Draw();
 
         // Show the big demo window
         ImGui::ShowDemoWindow();
@@ -0,0 +1,58 @@
+// Copyright (c) 2020-present, Roland Munguia & Tristan Florian Bouchard.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#ifndef CSYS_COLOR_SPAN_H
+#define CSYS_COLOR_SPAN_H
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+#include "csys/api.h"
+
+namespace csys
+{
+    /*!
+     * \brief
+     *      Color of item text, from an offset up to the next span
+     */
+    struct ColorSpan
+    {
+        uint32_t m_Offset;    //!< First character colored (In text with color codes removed)
+        uint32_t m_Color;     //!< Color, packed as R | G << 8 | B << 16 | A << 24 (0 = Default item color)
+    };
+
+    /*!
+     * \brief
+     *      Check for color codes (ANSI escape sequences or inline markup)
+     * \param text
+     *      Text to check
+     * \return
+     *      True if text may hold color codes
+     */
+    CSYS_API bool HasColorCodes(std::string_view text);
+
+    /*!
+     * \brief
+     *      Remove color codes from text, in place, recording the colors they set.
+     *      Understood codes:
+     *          - ANSI SGR sequences: ESC[0m (Reset), ESC[30-37m / ESC[90-97m (Colors), ESC[39m (Default),
+     *            ESC[38;5;Nm (256 colors) and ESC[38;2;R;G;Bm (True color). Other escape sequences are removed.
+     *          - Inline markup: {#RRGGBB} or {#RRGGBBAA} sets a color, {#} restores the default one.
+     * \param text
+     *      Text to parse, rewritten without color codes
+     * \param size
+     *      Size of text
+     * \param spans
+     *      Receives the color changes, in increasing offsets
+     * \return
+     *      Size of the text without color codes
+     */
+    CSYS_API size_t ParseColorSpans(char *text, size_t size, std::vector<ColorSpan> &spans);
+}
+
+#ifdef CSYS_HEADER_ONLY
+#include "csys/color_span.inl"
+#endif
+
+#endif //CSYS_COLOR_SPAN_H
@@ -0,0 +1,170 @@
+// Copyright (c) 2020-present, Roland Munguia & Tristan Florian Bouchard.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#ifndef CSYS_HEADER_ONLY
+
+#include "csys/color_span.h"
+
+#endif
+
+#include <cstring>
+#include "csys/string_search.h"
+
+namespace csys
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Helpers ////////////////////////////////////////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    static constexpr uint32_t ColorPack(uint32_t r, uint32_t g, uint32_t b, uint32_t a = 255)
+    {
+        return r | g << 8 | b << 16 | a << 24;
+    }
+
+    // Xterm palette: 16 base colors, 6x6x6 color cube and 24 grays.
+    static uint32_t AnsiColor(int index)
+    {
+        static const uint32_t s_Base[16] = {
+                ColorPack(0, 0, 0), ColorPack(205, 0, 0), ColorPack(0, 205, 0), ColorPack(205, 205, 0),
+                ColorPack(0, 0, 238), ColorPack(205, 0, 205), ColorPack(0, 205, 205), ColorPack(229, 229, 229),
+                ColorPack(127, 127, 127), ColorPack(255, 0, 0), ColorPack(0, 255, 0), ColorPack(255, 255, 0),
+                ColorPack(92, 92, 255), ColorPack(255, 0, 255), ColorPack(0, 255, 255), ColorPack(255, 255, 255)};
+
+        if (index < 16)
+            return s_Base[index];
+        if (index < 232)
+        {
+            static const uint32_t s_Levels[6] = {0, 95, 135, 175, 215, 255};
+            index -= 16;
+            return ColorPack(s_Levels[index / 36], s_Levels[index / 6 % 6], s_Levels[index % 6]);
+        }
+
+        auto gray = static_cast<uint32_t>(8 + (index - 232) * 10);
+        return ColorPack(gray, gray, gray);
+    }
+
+    static int HexDigit(char c)
+    {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        return -1;
+    }
+
+    // Color set by an SGR sequence parameters ("1;31"), or false if it doesn't change the color.
+    static bool SgrColor(const char *begin, const char *end, uint32_t &color)
+    {
+        // Parameters, empty ones are 0. (Long ones stop growing past 65535, so untrusted input can't overflow them)
+        int params[16];
+        int count = 0;
+        params[0] = 0;
+        for (const char *c = begin; c < end; ++c)
+        {
+            if (*c == ';')
+            {
+                if (++count == 16)
+                    break;
+                params[count] = 0;
+            }
+            else if (*c >= '0' && *c <= '9' && params[count] <= 65535)
+                params[count] = params[count] * 10 + (*c - '0');
+        }
+        count = count < 16 ? count + 1 : 16;
+
+        bool changed = false;
+        for (int i = 0; i < count; ++i)
+        {
+            int p = params[i];
+            if (p == 0 || p == 39)
+                color = 0;
+            else if (p >= 30 && p <= 37)
+                color = AnsiColor(p - 30);
+            else if (p >= 90 && p <= 97)
+                color = AnsiColor(p - 90 + 8);
+            else if (p == 38 && i + 2 < count && params[i + 1] == 5)
+            {
+                color = AnsiColor(params[i + 2] & 0xFF);
+                i += 2;
+            }
+            else if (p == 38 && i + 4 < count && params[i + 1] == 2)
+            {
+                color = ColorPack(params[i + 2] & 0xFF, params[i + 3] & 0xFF, params[i + 4] & 0xFF);
+                i += 4;
+            }
+            else
+                continue;
+            changed = true;
+        }
+        return changed;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Public methods /////////////////////////////////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    CSYS_INLINE bool HasColorCodes(std::string_view text)
+    {
+        return std::memchr(text.data(), '\x1b', text.size()) || Find(text, "{#") != std::string_view::npos;
+    }
+
+    CSYS_INLINE size_t ParseColorSpans(char *text, size_t size, std::vector<ColorSpan> &spans)
+    {
+        // Codes at the same offset replace each other, and setting the current color again is skipped.
+        size_t out = 0;
+        auto set = [&](uint32_t color)
+        {
+            if (!spans.empty() && spans.back().m_Offset == out)
+                spans.back().m_Color = color;
+            else if (spans.empty() ? color != 0 : spans.back().m_Color != color)
+                spans.push_back({static_cast<uint32_t>(out), color});
+        };
+
+        size_t in = 0;
+        while (in < size)
+        {
+            // Escape sequence, up to its final byte. (Only SGR ones, ending with 'm', set colors)
+            if (text[in] == '\x1b')
+            {
+                if (in + 1 < size && text[in + 1] == '[')
+                {
+                    size_t end = in + 2;
+                    while (end < size && (text[end] < 0x40 || text[end] > 0x7E))
+                        ++end;
+
+                    uint32_t color = spans.empty() ? 0 : spans.back().m_Color;
+                    if (end < size && text[end] == 'm' && SgrColor(text + in + 2, text + end, color))
+                        set(color);
+                    in = end < size ? end + 1 : size;
+                }
+                else
+                    ++in;
+                continue;
+            }
+
+            // Inline markup.
+            if (text[in] == '{' && in + 1 < size && text[in + 1] == '#')
+            {
+                size_t close = in + 2;
+                while (close < size && close - in - 2 < 8 && HexDigit(text[close]) >= 0)
+                    ++close;
+
+                size_t digits = close - in - 2;
+                if (close < size && text[close] == '}' && (digits == 0 || digits == 6 || digits == 8))
+                {
+                    uint32_t channels[4] = {0, 0, 0, 255};
+                    for (size_t i = 0; i < digits / 2; ++i)
+                        channels[i] = static_cast<uint32_t>(HexDigit(text[in + 2 + i * 2]) * 16 + HexDigit(text[in + 3 + i * 2]));
+                    set(digits ? ColorPack(channels[0], channels[1], channels[2], channels[3]) : 0);
+                    in = close + 1;
+                    continue;
+                }
+            }
+
+            text[out++] = text[in++];
+        }
+
+        return out;
+    }
+}
@@ -0,0 +1,283 @@
+// Copyright (c) 2020-present, Roland Munguia & Tristan Florian Bouchard.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#ifndef CSYS_FORMAT_H
+#define CSYS_FORMAT_H
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include "csys/api.h"
+
+// Format string literals are validated at compile time when consteval is available (C++20), at construction otherwise.
+#if defined(__cpp_consteval)
+#  define CSYS_CONSTEVAL consteval
+#else
+#  define CSYS_CONSTEVAL constexpr
+#endif
+
+// Format string validated at compile time whatever the language version: Log(INFO, CSYS_FMT("hp={}"), hp).
+#define CSYS_FMT(str) [] { struct Str : csys::CompiledFormat { static constexpr std::string_view Get() { return str; } }; return Str{}; }()
+
+namespace csys
+{
+    /*!
+     * \brief
+     *      Replacement field specification ("{:.2f}" -> precision 2, type 'f')
+     */
+    struct CSYS_API FormatSpec
+    {
+        char m_Type = '\0';       //!< Presentation type (d, x, X, f, e, g, s) or none
+        int m_Precision = -1;     //!< Floating point precision (-1 = Shortest representation)
+    };
+
+    /*!
+     * \brief
+     *      Format string tokens
+     */
+    enum FormatToken
+    {
+        FMT_END = 0,    //!< End of format string
+        FMT_LITERAL,    //!< Text to be copied as is
+        FMT_FIELD,      //!< Replacement field
+        FMT_ERROR       //!< Malformed format string
+    };
+
+    /*!
+     * \brief
+     *      Category of a format argument, used to validate replacement field specifications
+     */
+    enum FormatKind
+    {
+        FMT_KIND_OTHER = 0,    //!< Formatted through ItemLog operator<< (No specification allowed)
+        FMT_KIND_INTEGRAL,     //!< Integers (d, x, X)
+        FMT_KIND_FLOATING,     //!< Floating point (f, e, g, precision)
+        FMT_KIND_STRING        //!< Strings, chars and bools (s)
+    };
+
+    /*!
+     * \brief
+     *      Get the format category of a type
+     * \tparam T
+     *      Argument type
+     * \return
+     *      Format category
+     */
+    template<typename T>
+    constexpr FormatKind FormatKindOf()
+    {
+        using U = std::decay_t<T>;
+        if constexpr (std::is_same_v<U, bool> || std::is_same_v<U, char> || std::is_convertible_v<const U &, std::string_view>)
+            return FMT_KIND_STRING;
+        else if constexpr (std::is_integral_v<U>)
+            return FMT_KIND_INTEGRAL;
+        else if constexpr (std::is_floating_point_v<U>)
+            return FMT_KIND_FLOATING;
+        else
+            return FMT_KIND_OTHER;
+    }
+
+    /*!
+     * \brief
+     *      Read next token of a format string. ("{}" fields, "{{" and "}}" escapes)
+     * \param fmt
+     *      Format string
+     * \param pos
+     *      Current position, advanced past the token
+     * \param literal
+     *      Receives text to copy if token is FMT_LITERAL
+     * \param spec
+     *      Receives field specification if token is FMT_FIELD
+     * \return
+     *      Token read
+     */
+    constexpr FormatToken NextFormatToken(std::string_view fmt, size_t &pos, std::string_view &literal, FormatSpec &spec)
+    {
+        if (pos >= fmt.size())
+            return FMT_END;
+
+        // Escaped braces.
+        if ((fmt[pos] == '{' || fmt[pos] == '}') && pos + 1 < fmt.size() && fmt[pos + 1] == fmt[pos])
+        {
+            literal = fmt.substr(pos, 1);
+            pos += 2;
+            return FMT_LITERAL;
+        }
+
+        // Unmatched closing brace.
+        if (fmt[pos] == '}')
+            return FMT_ERROR;
+
+        // Plain text.
+        if (fmt[pos] != '{')
+        {
+            size_t end = pos;
+            while (end < fmt.size() && fmt[end] != '{' && fmt[end] != '}')
+                ++end;
+            literal = fmt.substr(pos, end - pos);
+            pos = end;
+            return FMT_LITERAL;
+        }
+
+        // Replacement field: {} or {:[.precision][type]}
+        spec = FormatSpec();
+        size_t i = pos + 1;
+        if (i < fmt.size() && fmt[i] == ':')
+        {
+            ++i;
+            if (i < fmt.size() && fmt[i] == '.')
+            {
+                spec.m_Precision = 0;
+                if (++i >= fmt.size() || fmt[i] < '0' || fmt[i] > '9')
+                    return FMT_ERROR;
+                for (; i < fmt.size() && fmt[i] >= '0' && fmt[i] <= '9'; ++i)
+                    spec.m_Precision = spec.m_Precision * 10 + (fmt[i] - '0');
+            }
+            if (i < fmt.size() && fmt[i] != '}')
+                spec.m_Type = fmt[i++];
+        }
+
+        if (i >= fmt.size() || fmt[i] != '}')
+            return FMT_ERROR;
+
+        pos = i + 1;
+        return FMT_FIELD;
+    }
+
+    /*!
+     * \brief
+     *      Check if a field specification can be applied to an argument category
+     * \param spec
+     *      Field specification
+     * \param kind
+     *      Argument category
+     * \return
+     *      True if valid
+     */
+    constexpr bool IsValidFormatSpec(const FormatSpec &spec, FormatKind kind)
+    {
+        switch (kind)
+        {
+            case FMT_KIND_INTEGRAL:
+                return spec.m_Precision < 0 && (spec.m_Type == '\0' || spec.m_Type == 'd' || spec.m_Type == 'x' || spec.m_Type == 'X');
+            case FMT_KIND_FLOATING:
+                return spec.m_Type == '\0' || spec.m_Type == 'f' || spec.m_Type == 'e' || spec.m_Type == 'g';
+            case FMT_KIND_STRING:
+                return spec.m_Precision < 0 && (spec.m_Type == '\0' || spec.m_Type == 's');
+            case FMT_KIND_OTHER:
+            default:
+                return spec.m_Precision < 0 && spec.m_Type == '\0';
+        }
+    }
+
+    /*!
+     * \brief
+     *      Validate a format string against the categories of its arguments
+     * \param fmt
+     *      Format string
+     * \param kinds
+     *      Argument categories, in order
+     * \param count
+     *      Number of arguments
+     * \return
+     *      True if well formed, and fields match arguments one to one
+     */
+    constexpr bool IsValidFormat(std::string_view fmt, const FormatKind *kinds, size_t count)
+    {
+        size_t pos = 0, field = 0;
+        std::string_view literal;
+        FormatSpec spec;
+        for (;;)
+        {
+            switch (NextFormatToken(fmt, pos, literal, spec))
+            {
+                case FMT_END:
+                    return field == count;
+                case FMT_FIELD:
+                    if (field >= count || !IsValidFormatSpec(spec, kinds[field]))
+                        return false;
+                    ++field;
+                    break;
+                case FMT_ERROR:
+                    return false;
+                case FMT_LITERAL:
+                default:
+                    break;
+            }
+        }
+    }
+
+    // Not constexpr on purpose: reaching it while validating a format string at compile time is a compile error.
+    inline void InvalidFormatString_FieldsDoNotMatchArguments()
+    {}
+
+    /*!
+     * \brief
+     *      Base of the format strings made by CSYS_FMT, which carry their string in their type (Str::Get())
+     */
+    struct CompiledFormat
+    {
+    };
+
+    /*!
+     * \brief
+     *      Same as T, used to keep format string arguments out of template deduction
+     */
+    template<typename T>
+    struct TypeIdentity
+    { using type = T; };
+
+    /*!
+     * \brief
+     *      Format string checked against the types of its arguments
+     * \tparam Args
+     *      Argument types
+     */
+    template<typename ...Args>
+    struct FormatString
+    {
+        /*!
+         * \brief
+         *      Validate format string literal
+         * \param str
+         *      Format string literal
+         */
+        template<size_t N>
+        CSYS_CONSTEVAL FormatString(const char (&str)[N]) : m_Str(str, N - 1)
+        {
+            m_Valid = IsValid(m_Str);
+#if defined(__cpp_consteval)
+            m_Static = true;
+            if (!m_Valid)
+                InvalidFormatString_FieldsDoNotMatchArguments();
+#endif
+        }
+
+        /*!
+         * \brief
+         *      Validate format string made by CSYS_FMT, at compile time
+         */
+        template<typename S, std::enable_if_t<std::is_base_of_v<CompiledFormat, S>, int> = 0>
+        constexpr FormatString(S) : m_Str(S::Get()), m_Valid(true), m_Static(true)
+        {
+            static_assert(IsValid(S::Get()), "Format string fields do not match arguments");
+        }
+
+        /*!
+         * \brief
+         *      Validate a format string against Args
+         */
+        static constexpr bool IsValid(std::string_view str)
+        {
+            constexpr FormatKind kinds[sizeof...(Args) + 1] = {FormatKindOf<Args>()..., FMT_KIND_OTHER};
+            return IsValidFormat(str, kinds, sizeof...(Args));
+        }
+
+        std::string_view m_Str;    //!< Format string
+        bool m_Valid = false;      //!< Did validation pass (Always true when checked at compile time: C++20 or CSYS_FMT)
+        bool m_Static = false;     //!< Was checked at compile time, so m_Str is a constant that outlives any use (C++20 or CSYS_FMT)
+    };
+}
+
+#endif //CSYS_FORMAT_H
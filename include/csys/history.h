@@ -6,6 +6,7 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include "csys/api.h"
 
@@ -57,11 +58,11 @@ namespace csys
 
         /*!
          * \brief
-         *      Record command string. (Start at the beginning once end is reached).
+         *      Record command string. (Start at the beginning once end is reached, reusing the recorded strings).
          * \param line
          *      Command string to be recorded.
          */
-        void PushBack(const std::string &line);
+        void PushBack(std::string_view line);
 
         /*!
          * \brief
@@ -22,9 +22,9 @@ namespace csys
     {
     }
 
-    CSYS_INLINE void CommandHistory::PushBack(const std::string &line)
+    CSYS_INLINE void CommandHistory::PushBack(std::string_view line)
     {
-        m_History[m_Record++ % m_MaxRecord] = line;
+        m_History[m_Record++ % m_MaxRecord].assign(line.data(), line.size());
     }
 
     CSYS_INLINE unsigned int CommandHistory::GetNewIndex() const
@@ -6,13 +6,31 @@
 #pragma once
 
 #include <vector>
+#include <array>
+#include <memory>
 #include <string>
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <tuple>
+#include <utility>
 #include "csys/api.h"
+#include "csys/color_span.h"
+#include "csys/format.h"
+#include "csys/mpsc_queue.h"
+#include "csys/ring_buffer.h"
+#include "csys/spill_file.h"
+#include "csys/text_arena.h"
+#include "csys/trigram_index.h"
 
 namespace csys
 {
     static const char endl = '\n';
 
+    class Sink;
+
     /*!
      * \brief
      *      Console item type:
@@ -33,6 +51,8 @@ namespace csys
         NONE
     };
 
+    class ItemLog;
+
     struct CSYS_API Item
     {
         /*!
@@ -53,11 +73,11 @@ namespace csys
 
         /*!
          * \brief
-         *      Copy constructor
+         *      Copy constructor. The copy owns its text, even if rhs lives inside an ItemLog
          * \param rhs
          *      Item to be copied.
          */
-        Item(const Item &rhs) = default;
+        Item(const Item &rhs);
 
         /*!
          * \brief
@@ -69,11 +89,11 @@ namespace csys
 
         /*!
          * \brief
-         *      Copy assigment operator.
+         *      Copy assigment operator. The copy owns its text, even if rhs lives inside an ItemLog
          * \param rhs
          *      Item to be copied.
          */
-        Item &operator=(const Item &rhs) = default;
+        Item &operator=(const Item &rhs);
 
         /*!
          * \brief
@@ -93,9 +113,75 @@ namespace csys
          */
         [[nodiscard]] std::string Get() const;
 
-        ItemType m_Type;             //!< Console item type
-        std::string m_Data;          //!< Item string data
-        unsigned int m_TimeStamp;    //!< Record timestamp
+        /*!
+         * \brief
+         *      Get final/styled string of the item without allocating. (The style prefix is stored with the data)
+         *      Deferred items are formatted the first time they are viewed.
+         * \return
+         *      View of the stylized item string. Valid until the item is modified or evicted from its log
+         */
+        [[nodiscard]] std::string_view View() const;
+
+        /*!
+         * \brief
+         *      Get item string data (Unstyled)
+         * \return
+         *      View of the item data. Valid until the item is modified or evicted from its log
+         */
+        [[nodiscard]] std::string_view Data() const;
+
+        /*!
+         * \brief
+         *      Wall clock time the item was created at (m_TimeStamp on top of the wall clock time the program started at)
+         * \return
+         *      System clock time point
+         */
+        [[nodiscard]] std::chrono::system_clock::time_point WallTime() const;
+
+        /*!
+         * \brief
+         *      Format local time of day the item was created at, as "HH:MM:SS:mmmm"
+         * \param out
+         *      Receives the time stamp (Null terminated)
+         * \return
+         *      Characters written (s_TimeStampSize)
+         */
+        size_t FormatTimeStamp(char (&out)[16]) const;
+
+        /*!
+         * \brief
+         *      Color span parsed from the item color codes (See ParseColorSpans). Spans are parsed when an item is sealed
+         *      in an ItemLog, or when a deferred item is formatted, and aren't kept by copies
+         * \param index
+         *      Span index, less than m_Spans
+         * \return
+         *      Color span, offset relative to View()
+         */
+        [[nodiscard]] ColorSpan Span(size_t index) const;
+
+        static constexpr size_t s_TimeStampSize = 13;          //!< Size of a formatted time stamp
+
+        ItemType m_Type;                                       //!< Console item type
+        mutable std::string m_Data;                            //!< Style prefix + item data (Items outside an ItemLog and formatted deferred items, use View())
+        uint64_t m_TimeStamp;                                  //!< Record timestamp (Steady nanoseconds since the program started)
+        const char *m_Text = nullptr;                          //!< Style prefix + item data (Or deferred record) inside ItemLog text arena
+        uint32_t m_Size = 0;                                   //!< Size of m_Text
+        uint32_t m_Chunk = TextArena::s_NoChunk;               //!< Text arena chunk holding m_Text
+        uint32_t m_Repeat = 1;                                 //!< Times the item was logged in a row (See ItemLog::CollapseDuplicates)
+        uint8_t m_Prefix = 0;                                  //!< Size of the style prefix
+        mutable bool m_Decoded = false;                        //!< Has the deferred record been formatted into m_Data
+        mutable uint16_t m_Spans = 0;                          //!< Color spans stored after the text (See Span())
+        void (*m_Decode)(const char *, ItemLog &) = nullptr;   //!< Formats the deferred record following the prefix and counter (Null for text items)
+    };
+
+    /*!
+     * \brief
+     *      Items logged by a command invocation (See ItemLog::BeginGroup)
+     */
+    struct ItemGroup
+    {
+        uint64_t m_Command;    //!< Id of the command item
+        uint64_t m_End;        //!< Id past the last output item. (Output is [m_Command + 1, m_End))
     };
 
 #define LOG_BASIC_TYPE_DECL(type) ItemLog& operator<<(type data)
@@ -106,7 +192,8 @@ namespace csys
 
         /*!
          * \brief
-         *      Log console item
+         *      Log console item. Text is appended to it with operator<< until it is sealed: when the next item is logged,
+         *      or posted items are drained. Text appended later goes to a new item of the same type
          * \param type
          *      Type of item to log
          * \return
@@ -114,7 +201,125 @@ namespace csys
          */
         ItemLog &log(ItemType type);
 
-        ItemLog() = default;
+        /*!
+         * \brief
+         *      Log an already built console item
+         * \param item
+         *      Item to log
+         * \return
+         *      Self (To allow for fluent logging)
+         */
+        ItemLog &log(Item item);
+
+        /*!
+         * \brief
+         *      Log console item from a format string. ("hp={} pos={:.2f}", hp, pos)
+         *      Arguments are written straight into the item storage, types without built-in formatting are written
+         *      with their ItemLog operator<< overload.
+         * \param type
+         *      Type of item to log
+         * \param fmt
+         *      Format string. Supports {}, {:d}, {:x}, {:X}, {:s}, {:.Nf}, {:.Ne}, {:.Ng}, {{ and }}
+         * \param args
+         *      Arguments matching the format string fields, in order
+         * \return
+         *      Self (To allow for fluent logging)
+         */
+        template<typename ...Args>
+        ItemLog &log(ItemType type, FormatString<typename TypeIdentity<Args>::type...> fmt, Args &&...args)
+        {
+            log(type);
+            return Format(fmt, std::forward<Args>(args)...);
+        }
+
+        /*!
+         * \brief
+         *      Log console item from a format string without formatting it. The format string and a raw copy of the
+         *      arguments are stored, the text is only produced when the item is viewed (Rendered, filtered, exported)
+         * \param type
+         *      Type of item to log
+         * \param fmt
+         *      Format string (See log(type, fmt, args...)). Referenced when checked at compile time (C++20 or CSYS_FMT),
+         *      copied into the record otherwise
+         * \param args
+         *      Trivially copyable or string arguments matching the format string fields, in order
+         * \return
+         *      Self (To allow for fluent logging, which formats the item)
+         */
+        template<typename ...Args>
+        ItemLog &Defer(ItemType type, FormatString<typename TypeIdentity<Args>::type...> fmt, Args &&...args)
+        {
+            static_assert(((IsDeferredString<Args>() || (std::is_trivially_copyable_v<std::decay_t<Args>> &&
+                                                         !std::is_pointer_v<std::decay_t<Args>>)) && ...),
+                          "Deferred arguments must be strings or trivially copyable non-pointer types");
+
+            if (!fmt.m_Valid)
+                return log(type, fmt, std::forward<Args>(args)...);
+
+            // Rate limited items have no record.
+            Item &item = Append(Item(type));
+            if (m_Discarding)
+                return *this;
+
+            // Record: counter of formatted bytes (See Item::View()), format string pointer and size, followed by the
+            // arguments. Under C++17 a literal may be any char array, which could be gone by the time the item is viewed,
+            // so its characters follow instead. (Null pointer)
+            if (!m_Formatted)
+                m_Formatted = std::make_unique<size_t>(0);
+            size_t *formatted = m_Formatted.get();
+            const char *str = fmt.m_Static ? fmt.m_Str.data() : nullptr;
+            size_t size = fmt.m_Str.size();
+            char *out = Reserve(sizeof(formatted) + sizeof(str) + sizeof(size) + (str ? 0 : size) + (DeferredSize(args) + ... + 0));
+            std::memcpy(out, &formatted, sizeof(formatted));
+            std::memcpy(out + sizeof(formatted), &str, sizeof(str));
+            std::memcpy(out + sizeof(formatted) + sizeof(str), &size, sizeof(size));
+            out += sizeof(formatted) + sizeof(str) + sizeof(size);
+            if (!str)
+            {
+                std::memcpy(out, fmt.m_Str.data(), size);
+                out += size;
+            }
+            ((out = DeferredWrite(out, args)), ...);
+
+            item.m_Decode = &DecodeDeferred<std::decay_t<Args>...>;
+            return *this;
+        }
+
+        /*!
+         * \brief
+         *      Append formatted text to the current console item (See log(type, fmt, args...))
+         * \param fmt
+         *      Format string
+         * \param args
+         *      Arguments matching the format string fields, in order
+         * \return
+         *      Self (To allow for fluent logging)
+         */
+        template<typename ...Args>
+        ItemLog &Format(FormatString<typename TypeIdentity<Args>::type...> fmt, Args &&...args)
+        {
+            // Format strings that couldn't be checked at compile time are logged as is.
+            if (!fmt.m_Valid)
+                return *this << "[Invalid format string] " << fmt.m_Str;
+
+            return FormatUnchecked(fmt.m_Str, args...);
+        }
+
+        /*!
+         * \brief
+         *      Create console item log
+         * \param maxItems
+         *      Maximum amount of items kept. Oldest items are evicted first (0 = Unbounded)
+         * \param maxBytes
+         *      Maximum amount of memory used by items. Oldest items are evicted first (0 = Unbounded)
+         */
+        explicit ItemLog(size_t maxItems = 0, size_t maxBytes = 0);
+
+        /*!
+         * \brief
+         *      Hand the newest item, and repeats not reported yet, to the sinks (See Flush())
+         */
+        ~ItemLog();
 
         /*!
          * \brief
@@ -126,11 +331,11 @@ namespace csys
 
         /*!
          * \brief
-         *      Copy constructor
+         *      Copy constructor. Item text is copied into the new log's own arena (Spill file isn't, see SpillFile)
          * \param rhs
          *      ItemLog to be copied.
          */
-        ItemLog(const ItemLog &rhs) = default;
+        ItemLog(const ItemLog &rhs);
 
         /*!
          * \brief
@@ -142,11 +347,11 @@ namespace csys
 
         /*!
          * \brief
-         *      Copy assigment operator.
+         *      Copy assigment operator. Item text is copied into this log's arena (See copy constructor)
          * \param rhs
          *      ItemLog to be copied.
          */
-        ItemLog &operator=(const ItemLog &rhs) = default;
+        ItemLog &operator=(const ItemLog &rhs);
 
         /*!
          * \brief
@@ -154,13 +359,221 @@ namespace csys
          * \return
          *      Console log
          */
-        std::vector<Item> &Items();
+        RingBuffer<Item> &Items();
 
         /*!
          * \brief Delete console item log history
          */
         void Clear();
 
+        /*!
+         * \brief
+         *      Cap the log size. Oldest items are evicted in O(1) once a limit is reached
+         * \param maxItems
+         *      Maximum amount of items kept (0 = Unbounded). Storage for all items is allocated up-front
+         * \param maxBytes
+         *      Maximum amount of memory used by items (0 = Unbounded). The newest item is never evicted
+         */
+        void SetCapacity(size_t maxItems, size_t maxBytes = 0);
+
+        /*!
+         * \brief
+         *      Write evicted items to disk instead of dropping them, so they can still be viewed and filtered
+         * \param path
+         *      Spill data file path (Truncated). An index file is created next to it (<path>.idx)
+         * \return
+         *      False if the files could not be created
+         */
+        bool Spill(const std::string &path);
+
+        /*!
+         * \brief
+         *      Get evicted items written to disk (See Spill())
+         * \return
+         *      Spilled lines, oldest first
+         */
+        SpillFile &Spilled();
+
+        /*!
+         * \return
+         *      Id of the oldest item, Items().front(). Every logged item gets the next id. Ids of sealed items are never
+         *      reused, but the newest item gives its id back when it is collapsed into the previous one (See
+         *      CollapseDuplicates()), so the next item gets it
+         */
+        [[nodiscard]] uint64_t FirstId() const;
+
+        /*!
+         * \return
+         *      Id after the newest sealed item. The newest item may still be appended to, colorized or collapsed until
+         *      sealed (Next Drain(), or next item logged), so text of items from here on isn't final
+         */
+        [[nodiscard]] uint64_t SealedId() const;
+
+        /*!
+         * \brief
+         *      Ids of the items of a type, maintained as items are logged and evicted
+         * \param type
+         *      Item type
+         * \return
+         *      Sorted ids, oldest first. (Item of an id is Items()[id - FirstId()])
+         */
+        [[nodiscard]] const RingBuffer<uint64_t> &TypeIndex(ItemType type) const;
+
+        /*!
+         * \brief
+         *      Start grouping items as output of the newest item, if it is a command. Every item logged until the matching
+         *      EndGroup() belongs to the group (Groups nest, an inner command's items belong to both)
+         */
+        void BeginGroup();
+
+        /*!
+         * \brief
+         *      End the group started by the matching BeginGroup()
+         */
+        void EndGroup();
+
+        /*!
+         * \brief
+         *      Find the output of a command
+         * \param command
+         *      Id of the command item
+         * \param group
+         *      Receives the command group. (Ends at the newest item while the command runs)
+         * \return
+         *      False if the item isn't a grouped command, or was evicted
+         */
+        bool FindGroup(uint64_t command, ItemGroup &group) const;
+
+        /*!
+         * \brief
+         *      Keep the text of logged items readable from other threads, even once evicted, until unpinned. Does not
+         *      cover formatted deferred items (See Item::m_Decode), whose text belongs to the item (Pins nest)
+         */
+        void Pin();
+
+        /*!
+         * \brief
+         *      Undo Pin()
+         */
+        void Unpin();
+
+        /*!
+         * \brief
+         *      Maintain a trigram index over item text, so substring searches don't have to scan every item. (Disabled by
+         *      default. Items are indexed as they are sealed, deferred ones are formatted to be indexed)
+         * \param enable
+         *      Enable indexing
+         */
+        void EnableSearchIndex(bool enable);
+
+        /*!
+         * \brief
+         *      Find items that may contain a string, through the search index (See EnableSearchIndex())
+         * \param str
+         *      String to look up (ASCII case insensitive)
+         * \param ids
+         *      Receives ids of the candidate items, sorted. Candidates still have to be checked
+         * \return
+         *      False if the index can't answer: disabled, string shorter than 3 characters, or live items not indexed
+         */
+        bool FindCandidates(std::string_view str, std::vector<uint64_t> &ids) const;
+
+        /*!
+         * \brief
+         *      Collapse consecutive identical items into the first one, counting repeats in Item::m_Repeat. (Commands are
+         *      never collapsed. Sinks get the repeat count once the run ends, see Sink::Repeated())
+         * \param collapse
+         *      Enable collapsing (Disabled by default)
+         */
+        void CollapseDuplicates(bool collapse);
+
+        /*!
+         * \brief
+         *      Limit how many items of a type are logged per second. Excess items are dropped, or sampled
+         * \param type
+         *      Item type to limit
+         * \param maxPerSecond
+         *      Items allowed per second (0 = Unlimited)
+         * \param sampleEvery
+         *      Keep one out of every sampleEvery excess items (0 = Drop all of them)
+         */
+        void SetRateLimit(ItemType type, size_t maxPerSecond, size_t sampleEvery = 0);
+
+        /*!
+         * \param type
+         *      Item type
+         * \return
+         *      Items of given type dropped by rate limiting so far
+         */
+        [[nodiscard]] size_t Dropped(ItemType type) const;
+
+        /*!
+         * \brief
+         *      Mirror logged items somewhere else (File, stdout, ...). Items are handed to sinks once complete, which is
+         *      when the next item is logged, or when posted items are drained (Once per frame for the console)
+         * \param sink
+         *      Sink to add
+         */
+        void AddSink(std::shared_ptr<Sink> sink);
+
+        /*!
+         * \brief
+         *      Stop mirroring items to a sink
+         * \param sink
+         *      Sink to remove
+         */
+        void RemoveSink(const std::shared_ptr<Sink> &sink);
+
+        /*!
+         * \brief
+         *      Hand every item, and the repeat count of the newest one, to the sinks, and flush them
+         */
+        void Flush();
+
+        /*!
+         * \return
+         *      Approximate memory used by logged items, in bytes
+         */
+        [[nodiscard]] size_t Bytes() const;
+
+        /*!
+         * \return
+         *      Total amount of items evicted by the capacity limits
+         */
+        [[nodiscard]] size_t Evicted() const;
+
+        /*!
+         * \return
+         *      Changes whenever sealed items change (Items sealed, collapsed, evicted or cleared)
+         */
+        [[nodiscard]] uint64_t Version() const;
+
+        /*!
+         * \brief
+         *      Queue an already built console item to be logged. Thread safe and lock-free, can be called from any thread
+         * \param item
+         *      Item to be logged on next Drain()
+         */
+        void Post(Item item);
+
+        /*!
+         * \brief
+         *      Queue a console item to be logged. Thread safe and lock-free, can be called from any thread
+         * \param type
+         *      Type of item to log
+         * \param str
+         *      Item data
+         */
+        void Post(ItemType type, std::string_view str);
+
+        /*!
+         * \brief
+         *      Move all posted items into the log. Must be called from the thread that owns the log (Once per frame)
+         * \return
+         *      Number of items drained
+         */
+        size_t Drain();
+
         LOG_BASIC_TYPE_DECL(int);
 
         LOG_BASIC_TYPE_DECL(long);
@@ -184,7 +597,236 @@ namespace csys
         LOG_BASIC_TYPE_DECL(char);
 
     protected:
-        std::vector<Item> m_Items;
+        /*!
+         * \brief
+         *      Format already validated format string
+         */
+        template<typename ...Args>
+        ItemLog &FormatUnchecked(std::string_view fmt, Args &...args)
+        {
+            size_t pos = 0;
+            (FormatNext(fmt, pos, args), ...);
+            FormatNext(fmt, pos);
+            return *this;
+        }
+
+        /*!
+         * \brief
+         *      Strings are copied into deferred records (Length + characters), everything else is copied raw
+         */
+        template<typename T>
+        static constexpr bool IsDeferredString()
+        { return std::is_convertible_v<const std::decay_t<T> &, std::string_view>; }
+
+        template<typename T>
+        using DeferredType = std::conditional_t<IsDeferredString<T>(), std::string_view, std::decay_t<T>>;
+
+        template<typename T>
+        static size_t DeferredSize(const T &arg)
+        {
+            if constexpr (IsDeferredString<T>())
+                return sizeof(uint32_t) + std::string_view(arg).size();
+            else
+                return sizeof(T);
+        }
+
+        template<typename T>
+        static char *DeferredWrite(char *out, const T &arg)
+        {
+            if constexpr (IsDeferredString<T>())
+            {
+                std::string_view str(arg);
+                auto size = static_cast<uint32_t>(str.size());
+                std::memcpy(out, &size, sizeof(size));
+                if (size)
+                    std::memcpy(out + sizeof(size), str.data(), size);
+                return out + sizeof(size) + size;
+            }
+            else
+            {
+                std::memcpy(out, &arg, sizeof(T));
+                return out + sizeof(T);
+            }
+        }
+
+        template<typename T>
+        static const char *DeferredRead(const char *in, T &value)
+        {
+            if constexpr (std::is_same_v<T, std::string_view>)
+            {
+                uint32_t size;
+                std::memcpy(&size, in, sizeof(size));
+                value = std::string_view(in + sizeof(size), size);
+                return in + sizeof(size) + size;
+            }
+            else
+            {
+                std::memcpy(&value, in, sizeof(T));
+                return in + sizeof(T);
+            }
+        }
+
+        /*!
+         * \brief
+         *      Format a deferred record into the current item of a log (Record following its formatted bytes counter)
+         */
+        template<typename ...Args>
+        static void DecodeDeferred(const char *record, ItemLog &log)
+        {
+            const char *str;
+            size_t size;
+            std::memcpy(&str, record, sizeof(str));
+            std::memcpy(&size, record + sizeof(str), sizeof(size));
+            record += sizeof(str) + sizeof(size);
+            if (!str)
+            {
+                str = record;
+                record += size;
+            }
+            std::string_view fmt(str, size);
+
+            std::tuple<DeferredType<Args>...> values;
+            std::apply([&](auto &...value)
+                       {
+                           ((record = DeferredRead(record, value)), ...);
+                           log.FormatUnchecked(fmt, value...);
+                       }, values);
+        }
+
+        /*!
+         * \brief
+         *      Copy format string literals up to the next field, then write the argument
+         */
+        template<typename T>
+        void FormatNext(std::string_view fmt, size_t &pos, T &arg)
+        {
+            std::string_view literal;
+            FormatSpec spec;
+            for (;;)
+            {
+                switch (NextFormatToken(fmt, pos, literal, spec))
+                {
+                    case FMT_LITERAL:
+                        *this << literal;
+                        break;
+                    case FMT_FIELD:
+                        FormatArg(spec, arg);
+                        return;
+                    default:
+                        return;
+                }
+            }
+        }
+
+        /*!
+         * \brief
+         *      Copy remaining format string literals
+         */
+        void FormatNext(std::string_view fmt, size_t &pos)
+        {
+            std::string_view literal;
+            FormatSpec spec;
+            while (NextFormatToken(fmt, pos, literal, spec) == FMT_LITERAL)
+                *this << literal;
+        }
+
+        /*!
+         * \brief
+         *      Write a single format argument into the current item
+         */
+        template<typename T>
+        void FormatArg(const FormatSpec &spec, T &arg)
+        {
+            using U = std::decay_t<T>;
+            if constexpr (std::is_same_v<U, bool>)
+                *this << std::string_view(arg ? "true" : "false");
+            else if constexpr (std::is_same_v<U, char>)
+                *this << arg;
+            else if constexpr (std::is_convertible_v<const U &, std::string_view>)
+                *this << std::string_view(arg);
+            else if constexpr (std::is_integral_v<U>)
+            {
+                // Enough for any 64 bit integer in base 10 or 16.
+                constexpr size_t max_size = 24;
+                char *out = Reserve(max_size);
+                auto result = std::to_chars(out, out + max_size, arg, spec.m_Type == 'x' || spec.m_Type == 'X' ? 16 : 10);
+                if (spec.m_Type == 'X')
+                    for (char *c = out; c != result.ptr; ++c)
+                        if (*c >= 'a' && *c <= 'f') *c = static_cast<char>(*c - 'a' + 'A');
+                Trim(out + max_size - result.ptr);
+            }
+            else if constexpr (std::is_floating_point_v<U>)
+            {
+                // Fixed notation of large values takes up to ~310 digits before the point.
+                const size_t max_size = (spec.m_Type == 'f' ? 320 : 32) + (spec.m_Precision > 0 ? spec.m_Precision : 0);
+                char *out = Reserve(max_size);
+#if defined(__cpp_lib_to_chars)
+                std::chars_format format = spec.m_Type == 'f' ? std::chars_format::fixed :
+                                           spec.m_Type == 'e' ? std::chars_format::scientific : std::chars_format::general;
+                auto result = spec.m_Precision < 0 ? (spec.m_Type ? std::to_chars(out, out + max_size, arg, format)
+                                                                  : std::to_chars(out, out + max_size, arg))
+                                                   : std::to_chars(out, out + max_size, arg, format, spec.m_Precision);
+                Trim(out + max_size - result.ptr);
+#else
+                // No floating point to_chars, format in place with the C library.
+                const char *format = spec.m_Type == 'f' ? "%.*Lf" : spec.m_Type == 'e' ? "%.*Le" : "%.*Lg";
+                int written = std::snprintf(out, max_size, format, spec.m_Precision < 0 ? 6 : spec.m_Precision, static_cast<long double>(arg));
+                size_t used = written < 0 ? 0 : std::min(static_cast<size_t>(written), max_size - 1);
+                Trim(max_size - used);
+#endif
+            }
+            else
+                *this << arg;
+        }
+
+        char *Reserve(size_t size);      //!< Grow the newest item by size uninitialized bytes, returns them (New item if sealed)
+        void Trim(size_t unused);        //!< Give back unused bytes from the end of the newest item
+        void Intern(Item &item);         //!< Move item text into the arena
+        Item &Append(Item &&item);       //!< Add item (Text is moved to the arena), evicting the oldest ones if needed
+        void Account(size_t bytes);      //!< Register bytes added to the newest item
+        void CountFormatted();           //!< Register deferred items formatted since last call
+        void Enforce();                  //!< Evict oldest items until capacity and memory limits are met
+        void EvictFront();               //!< Drop oldest item
+        void Seal();                     //!< Newest item is complete: collapse it, hand it to sinks and enforce limits
+        bool Collapse();                 //!< Merge newest item into the previous one if identical
+        void Colorize();                 //!< Replace newest item color codes with color spans
+        void ReportRepeats(const Item &item);    //!< Hand repeats of the newest item written to sinks, if not reported yet
+        bool Limit(const Item &item);    //!< Should item be dropped by rate limiting
+
+        struct RateLimit
+        {
+            size_t m_MaxPerSecond = 0;    //!< Items allowed per second (0 = Unlimited)
+            size_t m_SampleEvery = 0;     //!< Keep one out of every m_SampleEvery excess items
+            uint64_t m_Second = 0;        //!< Current one second window (From item timestamps)
+            size_t m_Count = 0;           //!< Items seen in current window
+            size_t m_Dropped = 0;         //!< Items dropped
+        };
+
+        RingBuffer<Item> m_Items;        //!< Logged items
+        TextArena m_Arena;               //!< Logged items text
+        SpillFile m_Spill;               //!< Evicted items (When enabled)
+        MpscQueue<Item> m_Posted;        //!< Items posted from other threads, waiting to be drained
+        size_t m_MaxItems = 0;           //!< Item limit (0 = Unbounded)
+        size_t m_MaxBytes = 0;           //!< Memory limit (0 = Unbounded)
+        size_t m_Bytes = 0;              //!< Memory used by logged items
+        std::unique_ptr<size_t> m_Formatted;    //!< Bytes of deferred items formatted by Item::View() not in m_Bytes yet (Stable address, records point to it)
+        size_t m_Evicted = 0;            //!< Items evicted so far
+        uint64_t m_Version = 0;          //!< Incremented whenever sealed items change
+        std::vector<std::shared_ptr<Sink>> m_Sinks;    //!< Item mirrors
+        std::array<RateLimit, NONE + 1> m_RateLimits;  //!< Rate limit of every item type
+        std::array<RingBuffer<uint64_t>, NONE + 1> m_TypeIndex;    //!< Ids of the items of every type
+        RingBuffer<ItemGroup> m_Groups;                            //!< Command groups, by command id
+        std::vector<uint64_t> m_GroupStack;                        //!< Commands of the open groups, innermost last
+        uint64_t m_FirstId = 0;                                    //!< Id of the oldest item
+        TrigramIndex m_Index;                                      //!< Search index over item text
+        bool m_Indexing = false;                                   //!< Is m_Index maintained
+        bool m_Collapse = false;                       //!< Collapse consecutive identical items
+        uint32_t m_Reported = 1;                       //!< Repeat count of the newest written item sinks know of
+        bool m_Open = false;                           //!< Newest item may still be appended to (Not sealed)
+        bool m_Discarding = false;                     //!< Newest item was dropped, text written to it is discarded
+        Item m_Discarded;                              //!< Stands for dropped items
+        std::vector<ColorSpan> m_SpanScratch;          //!< Spans of the item being colorized
+        std::string m_Scratch;                         //!< Receives text of dropped items
     };
 }
 
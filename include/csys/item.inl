@@ -9,7 +9,10 @@
 
 #endif
 
+#include "csys/sink.h"
 #include <chrono>
+#include <cstring>
+#include <ctime>
 
 namespace csys
 {
@@ -22,37 +25,148 @@ namespace csys
     CSYS_INLINE static const std::string_view s_Warning = "\t[WARNING]: ";
     CSYS_INLINE static const std::string_view s_Error = "[ERROR]: ";
     CSYS_INLINE static const auto s_TimeBegin = std::chrono::steady_clock::now();
+    CSYS_INLINE static const auto s_WallBegin = std::chrono::system_clock::now();
 
-    CSYS_INLINE Item::Item(ItemType type) : m_Type(type)
+    // Style prefix stored in front of the item data.
+    static std::string_view ItemPrefix(ItemType type)
+    {
+        switch (type)
+        {
+            case COMMAND:
+                return s_Command;
+            case LOG:
+                return "\t";
+            case WARNING:
+                return s_Warning;
+            case ERROR:
+                return s_Error;
+            case INFO:
+            case NONE:
+            default:
+                return "";
+        }
+    }
+
+    CSYS_INLINE Item::Item(ItemType type) : m_Type(type), m_Data(ItemPrefix(type))
     {
         auto timeNow = std::chrono::steady_clock::now();
-        m_TimeStamp = static_cast<unsigned int>(std::chrono::duration_cast<std::chrono::milliseconds>(timeNow - s_TimeBegin).count());
+        m_TimeStamp = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(timeNow - s_TimeBegin).count());
+        m_Prefix = static_cast<uint8_t>(m_Data.size());
+    }
+
+    CSYS_INLINE Item::Item(const Item &rhs) : m_Type(rhs.m_Type), m_Data(rhs.View()), m_TimeStamp(rhs.m_TimeStamp),
+                                              m_Repeat(rhs.m_Repeat), m_Prefix(rhs.m_Prefix)
+    {
+    }
+
+    CSYS_INLINE Item &Item::operator=(const Item &rhs)
+    {
+        if (this == &rhs)
+            return *this;
+
+        m_Type = rhs.m_Type;
+        m_Data = rhs.View();
+        m_TimeStamp = rhs.m_TimeStamp;
+        m_Text = nullptr;
+        m_Size = 0;
+        m_Chunk = TextArena::s_NoChunk;
+        m_Repeat = rhs.m_Repeat;
+        m_Prefix = rhs.m_Prefix;
+        m_Decoded = false;
+        m_Decode = nullptr;
+        m_Spans = 0;
+        return *this;
     }
 
     CSYS_INLINE Item &Item::operator<<(const std::string_view str)
     {
+        // Items inside a log can only grow through it, so take ownership of the text. (Log still releases m_Chunk)
+        if (m_Text)
+        {
+            m_Data = View();
+            m_Text = nullptr;
+            m_Decode = nullptr;
+            m_Spans = 0;
+        }
+
         m_Data.append(str);
         return *this;
     }
 
-    CSYS_INLINE std::string Item::Get() const
+    CSYS_INLINE std::string_view Item::View() const
     {
-        switch (m_Type)
+        // Format deferred record once, through a scratch log so user operator<< overloads apply.
+        if (m_Decode)
         {
-            case COMMAND:
-                return s_Command.data() + m_Data;
-            case LOG:
-                return '\t' + m_Data;
-            case WARNING:
-                return s_Warning.data() + m_Data;
-            case ERROR:
-                return s_Error.data() + m_Data;
-            case INFO:
-                return m_Data;
-            case NONE:
-            default:
-                return "";
+            if (!m_Decoded)
+            {
+                // Record starts with the counter of formatted bytes of its log, so they count against its memory limit.
+                size_t *formatted;
+                std::memcpy(&formatted, m_Text + m_Prefix, sizeof(formatted));
+
+                thread_local ItemLog scratch(1);
+                scratch.log(m_Type);
+                m_Decode(m_Text + m_Prefix + sizeof(formatted), scratch);
+                m_Data = scratch.Items().back().View();
+                m_Decoded = true;
+
+                // Color spans are stored after the formatted text.
+                if (HasColorCodes(m_Data))
+                {
+                    thread_local std::vector<ColorSpan> spans;
+                    spans.clear();
+                    m_Data.resize(ParseColorSpans(m_Data.data(), m_Data.size(), spans));
+                    m_Spans = static_cast<uint16_t>(std::min<size_t>(spans.size(), UINT16_MAX));
+                    m_Data.append(reinterpret_cast<const char *>(spans.data()), m_Spans * sizeof(ColorSpan));
+                }
+                *formatted += m_Data.size();
+            }
+            return std::string_view(m_Data.data(), m_Data.size() - m_Spans * sizeof(ColorSpan));
         }
+
+        std::string_view text = m_Text ? std::string_view(m_Text, m_Size) : std::string_view(m_Data);
+        return text.substr(0, text.size() - m_Spans * sizeof(ColorSpan));
+    }
+
+    CSYS_INLINE std::string_view Item::Data() const
+    {
+        return View().substr(m_Prefix);
+    }
+
+    CSYS_INLINE std::chrono::system_clock::time_point Item::WallTime() const
+    {
+        // Steady time stamps can't jump with clock adjustments, they are only anchored to the wall clock once.
+        return s_WallBegin + std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::nanoseconds(m_TimeStamp));
+    }
+
+    CSYS_INLINE ColorSpan Item::Span(size_t index) const
+    {
+        // Spans follow the text unaligned.
+        ColorSpan span;
+        std::string_view text = View();
+        std::memcpy(&span, text.data() + text.size() + index * sizeof(ColorSpan), sizeof(ColorSpan));
+        return span;
+    }
+
+    CSYS_INLINE size_t Item::FormatTimeStamp(char (&out)[16]) const
+    {
+        auto sinceEpoch = WallTime().time_since_epoch();
+        auto seconds = static_cast<std::time_t>(std::chrono::duration_cast<std::chrono::seconds>(sinceEpoch).count());
+        auto milliseconds = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(sinceEpoch).count() % 1000);
+
+        std::tm local{};
+#if defined(_WIN32)
+        localtime_s(&local, &seconds);
+#else
+        localtime_r(&seconds, &local);
+#endif
+        int size = std::snprintf(out, sizeof(out), "%02d:%02d:%02d:%04d", local.tm_hour, local.tm_min, local.tm_sec, milliseconds);
+        return size < 0 ? 0 : static_cast<size_t>(size);
+    }
+
+    CSYS_INLINE std::string Item::Get() const
+    {
+        return m_Type == NONE ? std::string() : std::string(View());
     }
 
     ///////////////////////////////////////////////////////////////////////////
@@ -62,37 +176,585 @@ namespace csys
 #define LOG_BASIC_TYPE_DEF(type)\
     CSYS_INLINE ItemLog& ItemLog::operator<<(type data)\
     {\
-        m_Items.back() << std::to_string(data);\
-        return *this;\
+        return *this << std::string_view(std::to_string(data));\
+    }
+
+    // Approximate memory footprint of a logged item.
+    // Formatted deferred items count their text too. (See ItemLog::CountFormatted())
+    static size_t FormattedBytes(const Item &item)
+    {
+        return item.m_Decode && item.m_Decoded ? item.m_Data.size() : 0;
+    }
+
+    static size_t ItemBytes(const Item &item)
+    {
+        return sizeof(Item) + item.m_Size + FormattedBytes(item);
+    }
+
+    CSYS_INLINE ItemLog::ItemLog(size_t maxItems, size_t maxBytes) : m_Items(maxItems ? maxItems + 1 : 0), m_MaxItems(maxItems),
+                                                                     m_MaxBytes(maxBytes)
+    {
+    }
+
+    CSYS_INLINE ItemLog::ItemLog(const ItemLog &rhs) : ItemLog(rhs.m_MaxItems, rhs.m_MaxBytes)
+    {
+        *this = rhs;
+    }
+
+    CSYS_INLINE ItemLog &ItemLog::operator=(const ItemLog &rhs)
+    {
+        if (this == &rhs)
+            return *this;
+
+        // Text is stored again in this arena (Color spans included), so memory accounting starts over.
+        m_Items.clear();
+        m_Items.set_capacity(rhs.m_Items.capacity());
+        m_Arena.Clear();
+        CountFormatted();
+        m_Bytes = 0;
+        for (const Item &item : rhs.m_Items)
+        {
+            std::string_view text = item.View();
+            std::string_view stored(text.data(), text.size() + item.m_Spans * sizeof(ColorSpan));
+            Item &copy = m_Items.emplace_back(item);
+            copy.m_Data = std::string();
+            copy.m_Text = m_Arena.Append(stored, copy.m_Chunk);
+            copy.m_Size = static_cast<uint32_t>(stored.size());
+            copy.m_Spans = item.m_Spans;
+            m_Bytes += ItemBytes(copy);
+        }
+
+        m_Spill = rhs.m_Spill;
+        m_Posted = rhs.m_Posted;
+        m_MaxItems = rhs.m_MaxItems;
+        m_MaxBytes = rhs.m_MaxBytes;
+        m_Evicted = rhs.m_Evicted;
+        ++m_Version;
+        m_Sinks = rhs.m_Sinks;
+        m_RateLimits = rhs.m_RateLimits;
+        m_TypeIndex = rhs.m_TypeIndex;
+        m_Groups = rhs.m_Groups;
+        m_GroupStack = rhs.m_GroupStack;
+        m_FirstId = rhs.m_FirstId;
+        m_Index = rhs.m_Index;
+        m_Indexing = rhs.m_Indexing;
+        m_Collapse = rhs.m_Collapse;
+        m_Reported = rhs.m_Reported;
+        m_Open = rhs.m_Open;
+        m_Discarding = rhs.m_Discarding;
+        m_Discarded = rhs.m_Discarded;
+        return *this;
+    }
+
+    CSYS_INLINE ItemLog::~ItemLog()
+    {
+        // Newest item and its repeats haven't reached sinks yet.
+        if (!m_Sinks.empty())
+            Flush();
     }
 
     CSYS_INLINE ItemLog &ItemLog::log(ItemType type)
     {
         // New item.
-        m_Items.emplace_back(type);
+        Append(Item(type));
+        return *this;
+    }
+
+    CSYS_INLINE ItemLog &ItemLog::log(Item item)
+    {
+        Append(std::move(item));
         return *this;
     }
 
-    CSYS_INLINE std::vector<Item> &ItemLog::Items()
+    CSYS_INLINE RingBuffer<Item> &ItemLog::Items()
     {
         return m_Items;
     }
 
     CSYS_INLINE void ItemLog::Clear()
     {
+        Seal();
+        if (!m_Items.empty())
+            ReportRepeats(m_Items.back());
+        m_FirstId += m_Items.size();
+        for (auto &index : m_TypeIndex)
+            index.clear();
+        m_Index.Clear();
+        m_Groups.clear();
         m_Items.clear();
+        m_Arena.Clear();
+        m_Spill.Clear();
+        CountFormatted();
+        m_Bytes = 0;
+        ++m_Version;
+    }
+
+    CSYS_INLINE bool ItemLog::Spill(const std::string &path)
+    {
+        return m_Spill.Open(path);
+    }
+
+    CSYS_INLINE SpillFile &ItemLog::Spilled()
+    {
+        return m_Spill;
+    }
+
+    CSYS_INLINE void ItemLog::AddSink(std::shared_ptr<Sink> sink)
+    {
+        // Items logged before the sink was added aren't replayed.
+        Seal();
+        m_Sinks.emplace_back(std::move(sink));
+    }
+
+    CSYS_INLINE void ItemLog::RemoveSink(const std::shared_ptr<Sink> &sink)
+    {
+        Seal();
+        m_Sinks.erase(std::remove(m_Sinks.begin(), m_Sinks.end(), sink), m_Sinks.end());
+    }
+
+    CSYS_INLINE void ItemLog::Flush()
+    {
+        Seal();
+        if (!m_Items.empty())
+            ReportRepeats(m_Items.back());
+        for (auto &sink : m_Sinks)
+            sink->Flush();
+    }
+
+    CSYS_INLINE uint64_t ItemLog::FirstId() const
+    {
+        return m_FirstId;
+    }
+
+    CSYS_INLINE uint64_t ItemLog::SealedId() const
+    {
+        return m_FirstId + m_Items.size() - m_Open;
+    }
+
+    CSYS_INLINE const RingBuffer<uint64_t> &ItemLog::TypeIndex(ItemType type) const
+    {
+        return m_TypeIndex[type];
+    }
+
+    // Command of a group that couldn't be started. (Newest item wasn't a logged command)
+    static constexpr uint64_t s_NoGroup = UINT64_MAX;
+
+    CSYS_INLINE void ItemLog::BeginGroup()
+    {
+        // Newest item may have been dropped by rate limiting, then it isn't the command.
+        uint64_t command = s_NoGroup;
+        if (!m_Discarding && !m_Items.empty() && m_Items.back().m_Type == COMMAND)
+        {
+            command = m_FirstId + m_Items.size() - 1;
+            m_Groups.emplace_back(ItemGroup{command, s_NoGroup});
+        }
+        m_GroupStack.emplace_back(command);
+    }
+
+    CSYS_INLINE void ItemLog::EndGroup()
+    {
+        if (m_GroupStack.empty())
+            return;
+        uint64_t command = m_GroupStack.back();
+        m_GroupStack.pop_back();
+
+        // Last output item may still collapse into the previous one, which would give its id back.
+        Seal();
+        auto group = std::lower_bound(m_Groups.begin(), m_Groups.end(), command, [](const ItemGroup &group, uint64_t id)
+        { return group.m_Command < id; });
+        if (group != m_Groups.end() && group->m_Command == command)
+            group->m_End = m_FirstId + m_Items.size();
+    }
+
+    CSYS_INLINE bool ItemLog::FindGroup(uint64_t command, ItemGroup &group) const
+    {
+        auto it = std::lower_bound(m_Groups.begin(), m_Groups.end(), command, [](const ItemGroup &group, uint64_t id)
+        { return group.m_Command < id; });
+        if (it == m_Groups.end() || it->m_Command != command)
+            return false;
+
+        group = *it;
+        group.m_End = std::min(group.m_End, m_FirstId + m_Items.size());
+        return true;
+    }
+
+    CSYS_INLINE void ItemLog::Pin()
+    {
+        m_Arena.Pin();
+    }
+
+    CSYS_INLINE void ItemLog::Unpin()
+    {
+        m_Arena.Unpin();
+    }
+
+    CSYS_INLINE void ItemLog::EnableSearchIndex(bool enable)
+    {
+        if (enable == m_Indexing)
+            return;
+
+        m_Indexing = enable;
+        m_Index = TrigramIndex();
+        if (!enable)
+            return;
+
+        // Index sealed items. (The open one will be when sealed)
+        for (uint64_t id = m_FirstId; id < SealedId(); ++id)
+            m_Index.Add(id, m_Items[id - m_FirstId].View());
+    }
+
+    CSYS_INLINE bool ItemLog::FindCandidates(std::string_view str, std::vector<uint64_t> &ids) const
+    {
+        if (!m_Indexing || m_Index.Base() > m_FirstId || !m_Index.Find(str, ids))
+        {
+            ids.clear();
+            return false;
+        }
+
+        // Newest item isn't indexed until sealed.
+        if (m_Open)
+            ids.push_back(m_FirstId + m_Items.size() - 1);
+        return true;
+    }
+
+    CSYS_INLINE void ItemLog::CollapseDuplicates(bool collapse)
+    {
+        m_Collapse = collapse;
+    }
+
+    CSYS_INLINE void ItemLog::SetRateLimit(ItemType type, size_t maxPerSecond, size_t sampleEvery)
+    {
+        RateLimit &limit = m_RateLimits[type];
+        limit.m_MaxPerSecond = maxPerSecond;
+        limit.m_SampleEvery = sampleEvery;
+        limit.m_Count = 0;
+    }
+
+    CSYS_INLINE size_t ItemLog::Dropped(ItemType type) const
+    {
+        return m_RateLimits[type].m_Dropped;
+    }
+
+    CSYS_INLINE void ItemLog::SetCapacity(size_t maxItems, size_t maxBytes)
+    {
+        // Evict what no longer fits.
+        Seal();
+        m_MaxItems = maxItems;
+        m_MaxBytes = maxBytes;
+        Enforce();
+
+        // One extra slot for the newest item, which is only evicted once sealed. (It may be collapsed)
+        m_Items.set_capacity(maxItems ? maxItems + 1 : 0);
+    }
+
+    CSYS_INLINE size_t ItemLog::Bytes() const
+    {
+        return m_Bytes + (m_Formatted ? *m_Formatted : 0);
+    }
+
+    CSYS_INLINE size_t ItemLog::Evicted() const
+    {
+        return m_Evicted;
+    }
+
+    CSYS_INLINE uint64_t ItemLog::Version() const
+    {
+        return m_Version;
+    }
+
+    CSYS_INLINE Item &ItemLog::Append(Item &&item)
+    {
+        // Previous item is complete.
+        Seal();
+
+        // Text logged to dropped items goes nowhere.
+        m_Discarding = Limit(item);
+        if (m_Discarding)
+        {
+            m_Discarded = Item(NONE);
+            return m_Discarded;
+        }
+
+        // Make room.
+        if (m_Items.full())
+            EvictFront();
+
+        Item &added = m_Items.emplace_back(std::move(item));
+        added.m_Chunk = TextArena::s_NoChunk;
+        added.m_Repeat = 1;
+        Intern(added);
+        m_TypeIndex[added.m_Type].emplace_back(m_FirstId + m_Items.size() - 1);
+
+        m_Open = true;
+        Account(ItemBytes(added));
+        return added;
+    }
+
+    CSYS_INLINE void ItemLog::Intern(Item &item)
+    {
+        std::string_view text = item.View();
+        uint32_t chunk;
+        char *stored = m_Arena.Append(text, chunk);
+
+        // Formatted text moves to the arena, the caller accounts for it.
+        CountFormatted();
+        m_Bytes -= FormattedBytes(item);
+
+        // Drop previous block. (Item may have taken ownership of its text, see Item::operator<<)
+        if (item.m_Chunk != TextArena::s_NoChunk)
+            m_Arena.Release(item.m_Chunk);
+
+        item.m_Text = stored;
+        item.m_Size = static_cast<uint32_t>(text.size());
+        item.m_Chunk = chunk;
+        item.m_Data = std::string();
+        item.m_Decode = nullptr;
+        item.m_Decoded = false;
+        item.m_Spans = 0;
+    }
+
+    CSYS_INLINE char *ItemLog::Reserve(size_t size)
+    {
+        // Sealed items can't grow: they were colorized (Spans follow the text), collapsed and handed to sinks.
+        if (!m_Open && !m_Discarding)
+            Append(Item(m_Items.empty() ? LOG : m_Items.back().m_Type));
+
+        if (m_Discarding)
+        {
+            m_Scratch.resize(size);
+            return m_Scratch.data();
+        }
+
+        // Text must be in the arena to grow. (Deferred items are formatted first)
+        Item &item = m_Items.back();
+        if (!item.m_Text || item.m_Decode)
+        {
+            m_Bytes -= item.m_Size;
+            Intern(item);
+            Account(item.m_Size);
+        }
+
+        // Grow item text inside the arena.
+        item.m_Text = m_Arena.Grow(item.m_Text, item.m_Size, size, item.m_Chunk);
+        item.m_Size += static_cast<uint32_t>(size);
+        Account(size);
+        return const_cast<char *>(item.m_Text) + item.m_Size - size;
+    }
+
+    CSYS_INLINE void ItemLog::Trim(size_t unused)
+    {
+        if (m_Discarding)
+            return;
+
+        Item &item = m_Items.back();
+        m_Arena.Shrink(item.m_Text, item.m_Size, unused, item.m_Chunk);
+        item.m_Size -= static_cast<uint32_t>(unused);
+        m_Bytes -= unused;
+    }
+
+    CSYS_INLINE void ItemLog::Account(size_t bytes)
+    {
+        m_Bytes += bytes;
+    }
+
+    CSYS_INLINE void ItemLog::CountFormatted()
+    {
+        // Moved from logs have no counter.
+        if (m_Formatted)
+            m_Bytes += std::exchange(*m_Formatted, 0);
+    }
+
+    CSYS_INLINE void ItemLog::Enforce()
+    {
+        CountFormatted();
+        while (m_MaxItems && m_Items.size() > m_MaxItems)
+            EvictFront();
+
+        // Newest item is kept even if it doesn't fit by itself.
+        while (m_MaxBytes && m_Bytes > m_MaxBytes && m_Items.size() > 1)
+            EvictFront();
+
+        if (m_Indexing)
+            m_Index.Drop(m_FirstId);
+    }
+
+    CSYS_INLINE void ItemLog::EvictFront()
+    {
+        Item &front = m_Items.front();
+        if (m_Items.size() - m_Open == 1)
+            ReportRepeats(front);
+        if (m_Spill.IsOpen())
+            m_Spill.Append(front.View(), front.m_Type);
+
+        CountFormatted();
+        m_Bytes -= ItemBytes(front);
+        if (front.m_Chunk != TextArena::s_NoChunk)
+            m_Arena.Release(front.m_Chunk);
+        m_TypeIndex[front.m_Type].pop_front();
+        m_Items.pop_front();
+        ++m_FirstId;
+        while (!m_Groups.empty() && m_Groups.front().m_Command < m_FirstId)
+            m_Groups.pop_front();
+        ++m_Evicted;
+        ++m_Version;
+    }
+
+    CSYS_INLINE void ItemLog::Seal()
+    {
+        if (!m_Open)
+            return;
+        ++m_Version;
+
+        // Still open, so its text can shrink and grow.
+        Colorize();
+        m_Open = false;
+
+        if (!Collapse())
+        {
+            // Run of the previous item ended.
+            if (m_Items.size() > 1)
+                ReportRepeats(m_Items[m_Items.size() - 2]);
+
+            if (m_Indexing)
+                m_Index.Add(m_FirstId + m_Items.size() - 1, m_Items.back().View());
+
+            for (auto &sink : m_Sinks)
+                sink->Write(m_Items.back());
+            m_Reported = 1;
+        }
+
+        Enforce();
+    }
+
+    CSYS_INLINE void ItemLog::ReportRepeats(const Item &item)
+    {
+        if (item.m_Repeat <= m_Reported)
+            return;
+
+        m_Reported = item.m_Repeat;
+        for (auto &sink : m_Sinks)
+            sink->Repeated(item);
+    }
+
+    CSYS_INLINE void ItemLog::Colorize()
+    {
+        // Deferred items are colorized when formatted.
+        Item &item = m_Items.back();
+        if (item.m_Decode || !item.m_Text || !HasColorCodes(item.View()))
+            return;
+
+        // Strip codes in place, then store spans after the text. (Item text is the newest arena block, so it can shrink and grow)
+        m_SpanScratch.clear();
+        size_t size = ParseColorSpans(const_cast<char *>(item.m_Text), item.m_Size, m_SpanScratch);
+        Trim(item.m_Size - size);
+
+        auto spans = static_cast<uint16_t>(std::min<size_t>(m_SpanScratch.size(), UINT16_MAX));
+        if (spans)
+        {
+            std::memcpy(Reserve(spans * sizeof(ColorSpan)), m_SpanScratch.data(), spans * sizeof(ColorSpan));
+            item.m_Spans = spans;
+        }
+    }
+
+    CSYS_INLINE bool ItemLog::Collapse()
+    {
+        if (!m_Collapse || m_Items.size() < 2)
+            return false;
+
+        Item &newest = m_Items.back();
+        Item &previous = m_Items[m_Items.size() - 2];
+        if (newest.m_Type == COMMAND || newest.m_Type != previous.m_Type)
+            return false;
+
+        // Deferred records are compared as is, so neither has to be formatted. Color spans follow text and are compared too.
+        auto colored = [](const Item &item)
+        { return std::string_view(item.View().data(), item.View().size() + item.m_Spans * sizeof(ColorSpan)); };
+        bool same = newest.m_Decode || previous.m_Decode
+                    ? newest.m_Decode == previous.m_Decode &&
+                      std::string_view(newest.m_Text, newest.m_Size) == std::string_view(previous.m_Text, previous.m_Size)
+                    : colored(newest) == colored(previous);
+        if (!same)
+            return false;
+
+        ++previous.m_Repeat;
+
+        // Give text back to the arena, so repeats don't use memory.
+        CountFormatted();
+        m_Bytes -= ItemBytes(newest);
+        if (newest.m_Chunk != TextArena::s_NoChunk)
+        {
+            m_Arena.Shrink(newest.m_Text, newest.m_Size, newest.m_Size, newest.m_Chunk);
+            m_Arena.Release(newest.m_Chunk);
+        }
+        m_TypeIndex[newest.m_Type].pop_back();
+        m_Items.pop_back();
+        return true;
+    }
+
+    CSYS_INLINE bool ItemLog::Limit(const Item &item)
+    {
+        RateLimit &limit = m_RateLimits[item.m_Type];
+        if (!limit.m_MaxPerSecond)
+            return false;
+
+        // New window every second.
+        uint64_t second = item.m_TimeStamp / 1000000000;
+        if (second != limit.m_Second)
+        {
+            limit.m_Second = second;
+            limit.m_Count = 0;
+        }
+
+        if (++limit.m_Count <= limit.m_MaxPerSecond)
+            return false;
+
+        // Keep a sample of the excess.
+        if (limit.m_SampleEvery && (limit.m_Count - limit.m_MaxPerSecond) % limit.m_SampleEvery == 0)
+            return false;
+
+        ++limit.m_Dropped;
+        return true;
+    }
+
+    CSYS_INLINE void ItemLog::Post(Item item)
+    {
+        m_Posted.Push(std::move(item));
+    }
+
+    CSYS_INLINE void ItemLog::Post(ItemType type, std::string_view str)
+    {
+        Item item(type);
+        item << str;
+        m_Posted.Push(std::move(item));
+    }
+
+    CSYS_INLINE size_t ItemLog::Drain()
+    {
+        // Items keep the order they were posted in (Per producer), and are stamped at post time.
+        size_t count = 0;
+        Item item;
+        while (m_Posted.Pop(item))
+        {
+            Append(std::move(item));
+            ++count;
+        }
+
+        // Nothing is appended to items between frames.
+        Seal();
+        return count;
     }
 
     CSYS_INLINE ItemLog &ItemLog::operator<<(const std::string_view data)
     {
-        m_Items.back() << data;
+        char *out = Reserve(data.size());
+        if (!data.empty())
+            std::memcpy(out, data.data(), data.size());
         return *this;
     }
 
     CSYS_INLINE ItemLog &ItemLog::operator<<(const char data)
     {
-        m_Items.back().m_Data.append(1, data);
-        return *this;
+        return *this << std::string_view(&data, 1);
     }
 
     // Basic type operator definitions.
@@ -0,0 +1,145 @@
+// Copyright (c) 2020-present, Roland Munguia & Tristan Florian Bouchard.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#ifndef CSYS_MPSC_QUEUE_H
+#define CSYS_MPSC_QUEUE_H
+#pragma once
+
+#include <atomic>
+#include <utility>
+#include "csys/api.h"
+
+namespace csys
+{
+    /*!
+     * \brief
+     *      Lock-free multiple producer single consumer queue (Intrusive node based, Dmitry Vyukov's algorithm).
+     *      Any thread may Push, only one thread at a time may Pop.
+     * \tparam T
+     *      Type of the elements to be queued
+     */
+    template<typename T>
+    class CSYS_API MpscQueue
+    {
+    public:
+
+        /*!
+         * \brief
+         *      Create empty queue
+         */
+        MpscQueue() : m_Head(new Node()), m_Tail(m_Head.load(std::memory_order_relaxed))
+        {}
+
+        /*!
+         * \brief
+         *      Copy constructor. Pending elements belong to the consumer of rhs, so an empty queue is created.
+         * \param rhs
+         *      Queue to be copied.
+         */
+        MpscQueue(const MpscQueue &rhs [[maybe_unused]]) : MpscQueue()
+        {}
+
+        /*!
+         * \brief
+         *      Move constructor. Pending elements of rhs are transferred. (No producer may be using rhs)
+         * \param rhs
+         *      Queue to be moved.
+         */
+        MpscQueue(MpscQueue &&rhs) : MpscQueue()
+        {
+            T value;
+            while (rhs.Pop(value))
+                Push(std::move(value));
+        }
+
+        /*!
+         * \brief
+         *      Copy assignment operator. Leaves pending elements untouched.
+         * \param rhs
+         *      Queue to be copied.
+         */
+        MpscQueue &operator=(const MpscQueue &rhs [[maybe_unused]])
+        { return *this; }
+
+        /*!
+         * \brief
+         *      Move assignment operator. Pending elements of rhs are appended. (No producer may be using rhs)
+         * \param rhs
+         *      Queue to be moved.
+         */
+        MpscQueue &operator=(MpscQueue &&rhs)
+        {
+            T value;
+            while (this != &rhs && rhs.Pop(value))
+                Push(std::move(value));
+            return *this;
+        }
+
+        /*!
+         * \brief
+         *      Destroy queue and all pending elements
+         */
+        ~MpscQueue()
+        {
+            while (m_Tail)
+            {
+                Node *next = m_Tail->m_Next.load(std::memory_order_relaxed);
+                delete m_Tail;
+                m_Tail = next;
+            }
+        }
+
+        /*!
+         * \brief
+         *      Enqueue element. Safe to call from any thread, never blocks on other producers or the consumer.
+         * \param value
+         *      Element to be queued
+         */
+        void Push(T value)
+        {
+            Node *node = new Node(std::move(value));
+            Node *prev = m_Head.exchange(node, std::memory_order_acq_rel);
+            prev->m_Next.store(node, std::memory_order_release);
+        }
+
+        /*!
+         * \brief
+         *      Dequeue oldest element. Must only be called from the consumer thread.
+         * \param value
+         *      Receives the dequeued element
+         * \return
+         *      False if no element was ready
+         */
+        bool Pop(T &value)
+        {
+            Node *tail = m_Tail;
+            Node *next = tail->m_Next.load(std::memory_order_acquire);
+
+            // Empty, or a producer is between exchange and link (Will be visible on next pop).
+            if (!next)
+                return false;
+
+            value = std::move(next->m_Value);
+            m_Tail = next;
+            delete tail;
+            return true;
+        }
+
+    protected:
+        struct Node
+        {
+            Node() = default;
+
+            explicit Node(T value) : m_Value(std::move(value))
+            {}
+
+            T m_Value{};                            //!< Queued element (Stub node holds none)
+            std::atomic<Node *> m_Next{nullptr};    //!< Next newer node
+        };
+
+        std::atomic<Node *> m_Head;    //!< Newest node (Producers side)
+        Node *m_Tail;                  //!< Stub/oldest consumed node (Consumer side)
+    };
+}
+
+#endif //CSYS_MPSC_QUEUE_H
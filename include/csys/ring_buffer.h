@@ -0,0 +1,218 @@
+// Copyright (c) 2020-present, Roland Munguia & Tristan Florian Bouchard.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#ifndef CSYS_RING_BUFFER_H
+#define CSYS_RING_BUFFER_H
+#pragma once
+
+#include <vector>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include "csys/api.h"
+
+namespace csys
+{
+    /*!
+     * \brief
+     *      Double ended FIFO container over a circular buffer. Mirrors the std::vector interface so it can be used as a
+     *      drop-in replacement when iterating, while allowing O(1) removal of the oldest element.
+     *          - Unbounded: Grows like a vector (Elements are linearized on reallocation).
+     *          - Bounded: All storage is allocated up-front and never reallocated, push_back is only valid when not full.
+     * \tparam T
+     *      Type of the elements stored. (Must be default constructible)
+     */
+    template<typename T>
+    class CSYS_API RingBuffer
+    {
+    public:
+
+        /*!
+         * \brief
+         *      Random access iterator over the ring buffer, from oldest to newest element
+         * \tparam Buffer
+         *      Buffer type (Const or non-const ring buffer)
+         * \tparam Value
+         *      Element type (Const or non-const T)
+         */
+        template<typename Buffer, typename Value>
+        class Iterator
+        {
+        public:
+            using iterator_category = std::random_access_iterator_tag;
+            using value_type = std::remove_const_t<Value>;
+            using difference_type = std::ptrdiff_t;
+            using pointer = Value *;
+            using reference = Value &;
+
+            Iterator() = default;
+
+            Iterator(Buffer *buffer, size_t index) : m_Buffer(buffer), m_Index(index)
+            {}
+
+            reference operator*() const { return (*m_Buffer)[m_Index]; }
+            pointer operator->() const { return &(*m_Buffer)[m_Index]; }
+            reference operator[](difference_type n) const { return (*m_Buffer)[m_Index + n]; }
+
+            Iterator &operator++() { ++m_Index; return *this; }
+            Iterator &operator--() { --m_Index; return *this; }
+            Iterator operator++(int) { Iterator it = *this; ++m_Index; return it; }
+            Iterator operator--(int) { Iterator it = *this; --m_Index; return it; }
+            Iterator &operator+=(difference_type n) { m_Index += n; return *this; }
+            Iterator &operator-=(difference_type n) { m_Index -= n; return *this; }
+            Iterator operator+(difference_type n) const { return Iterator(m_Buffer, m_Index + n); }
+            Iterator operator-(difference_type n) const { return Iterator(m_Buffer, m_Index - n); }
+            difference_type operator-(const Iterator &rhs) const { return difference_type(m_Index) - difference_type(rhs.m_Index); }
+
+            bool operator==(const Iterator &rhs) const { return m_Index == rhs.m_Index; }
+            bool operator!=(const Iterator &rhs) const { return m_Index != rhs.m_Index; }
+            bool operator<(const Iterator &rhs) const { return m_Index < rhs.m_Index; }
+            bool operator>(const Iterator &rhs) const { return m_Index > rhs.m_Index; }
+            bool operator<=(const Iterator &rhs) const { return m_Index <= rhs.m_Index; }
+            bool operator>=(const Iterator &rhs) const { return m_Index >= rhs.m_Index; }
+
+        private:
+            Buffer *m_Buffer = nullptr;    //!< Iterated buffer
+            size_t m_Index = 0;            //!< Logical index (0 = oldest)
+        };
+
+        using value_type = T;
+        using size_type = size_t;
+        using reference = T &;
+        using const_reference = const T &;
+        using iterator = Iterator<RingBuffer, T>;
+        using const_iterator = Iterator<const RingBuffer, const T>;
+
+        /*!
+         * \brief
+         *      Create ring buffer
+         * \param capacity
+         *      Maximum number of elements. (0 = Unbounded)
+         */
+        explicit RingBuffer(size_t capacity = 0)
+        { set_capacity(capacity); }
+
+        /*!
+         * \brief
+         *      Set maximum number of elements. Oldest elements are dropped if they don't fit
+         * \param capacity
+         *      Maximum number of elements. (0 = Unbounded)
+         */
+        void set_capacity(size_t capacity)
+        {
+            while (capacity && m_Size > capacity)
+                pop_front();
+
+            m_Bounded = capacity != 0;
+            Reallocate(m_Bounded ? capacity : m_Size);
+        }
+
+        /*!
+         * \return
+         *      Maximum number of elements. (0 = Unbounded)
+         */
+        [[nodiscard]] size_t capacity() const
+        { return m_Bounded ? m_Slots.size() : 0; }
+
+        /*!
+         * \return
+         *      True if bounded and no more elements can be pushed without popping first
+         */
+        [[nodiscard]] bool full() const
+        { return m_Bounded && m_Size == m_Slots.size(); }
+
+        [[nodiscard]] size_t size() const { return m_Size; }
+        [[nodiscard]] bool empty() const { return m_Size == 0; }
+
+        T &operator[](size_t i) { return m_Slots[Slot(i)]; }
+        const T &operator[](size_t i) const { return m_Slots[Slot(i)]; }
+
+        T &front() { return m_Slots[m_Head]; }
+        const T &front() const { return m_Slots[m_Head]; }
+        T &back() { return (*this)[m_Size - 1]; }
+        const T &back() const { return (*this)[m_Size - 1]; }
+
+        iterator begin() { return iterator(this, 0); }
+        iterator end() { return iterator(this, m_Size); }
+        const_iterator begin() const { return const_iterator(this, 0); }
+        const_iterator end() const { return const_iterator(this, m_Size); }
+
+        /*!
+         * \brief
+         *      Construct element at the back of the buffer. (Buffer must not be full)
+         * \param args
+         *      Arguments forwarded to the element constructor
+         * \return
+         *      Newly added element
+         */
+        template<typename ...Args>
+        T &emplace_back(Args &&... args)
+        {
+            if (m_Size == m_Slots.size())
+                Reallocate(m_Slots.empty() ? 16 : m_Slots.size() * 2);
+
+            T &slot = m_Slots[Slot(m_Size++)];
+            slot = T(std::forward<Args>(args)...);
+            return slot;
+        }
+
+        /*!
+         * \brief
+         *      Remove oldest element in O(1). The slot is reset so the element's resources are released immediately
+         */
+        void pop_front()
+        {
+            m_Slots[m_Head] = T();
+            m_Head = m_Head + 1 == m_Slots.size() ? 0 : m_Head + 1;
+            --m_Size;
+        }
+
+        /*!
+         * \brief
+         *      Remove newest element in O(1). The slot is reset so the element's resources are released immediately
+         */
+        void pop_back()
+        {
+            (*this)[m_Size - 1] = T();
+            --m_Size;
+        }
+
+        /*!
+         * \brief
+         *      Remove all elements (Keeps storage)
+         */
+        void clear()
+        {
+            while (m_Size)
+                pop_front();
+            m_Head = 0;
+        }
+
+    protected:
+        [[nodiscard]] size_t Slot(size_t i) const
+        {
+            i += m_Head;
+            return i >= m_Slots.size() ? i - m_Slots.size() : i;
+        }
+
+        void Reallocate(size_t slots)
+        {
+            if (slots == m_Slots.size())
+                return;
+
+            std::vector<T> linear(slots);
+            for (size_t i = 0; i < m_Size; ++i)
+                linear[i] = std::move((*this)[i]);
+
+            m_Slots.swap(linear);
+            m_Head = 0;
+        }
+
+        std::vector<T> m_Slots;    //!< Element storage
+        size_t m_Head = 0;         //!< Slot of the oldest element
+        size_t m_Size = 0;         //!< Number of stored elements
+        bool m_Bounded = false;    //!< Does the buffer have a fixed capacity
+    };
+}
+
+#endif //CSYS_RING_BUFFER_H
@@ -0,0 +1,166 @@
+// Copyright (c) 2020-present, Roland Munguia & Tristan Florian Bouchard.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#ifndef CSYS_SINK_H
+#define CSYS_SINK_H
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "csys/api.h"
+#include "csys/item.h"
+
+namespace csys
+{
+    /*!
+     * \brief
+     *      Receives every item logged to an ItemLog, once the item is complete (See ItemLog::AddSink)
+     */
+    class CSYS_API Sink
+    {
+    public:
+
+        virtual ~Sink() = default;
+
+        /*!
+         * \brief
+         *      Called on the logging thread for every completed item. Must not block
+         * \param item
+         *      Logged item
+         */
+        virtual void Write(const Item &item) = 0;
+
+        /*!
+         * \brief
+         *      Called on the logging thread when identical items were collapsed into an already written one (See
+         *      ItemLog::CollapseDuplicates), once the run of repeats ends or the log is flushed. Must not block
+         * \param item
+         *      Written item, item.m_Repeat is the total amount of times it was logged so far
+         */
+        virtual void Repeated(const Item &item [[maybe_unused]])
+        {}
+
+        /*!
+         * \brief
+         *      Make sure everything written so far reached its destination
+         */
+        virtual void Flush()
+        {}
+    };
+
+    /*!
+     * \brief
+     *      Sink mirroring items to a file (Or stdout/stderr). Items are copied to an in-memory backlog and written by a
+     *      background thread in large batches, so the logging thread never waits on I/O.
+     */
+    class CSYS_API AsyncFileSink : public Sink
+    {
+    public:
+
+        /*!
+         * \brief
+         *      Create sink writing to a file
+         * \param path
+         *      File path (Truncated)
+         * \param flushInterval
+         *      Maximum time items wait in the backlog before being written
+         * \param maxBacklog
+         *      Maximum bytes waiting to be written. Items that don't fit are dropped (See Dropped())
+         */
+        explicit AsyncFileSink(const std::string &path, std::chrono::milliseconds flushInterval = std::chrono::milliseconds(250),
+                               size_t maxBacklog = 4 * 1024 * 1024);
+
+        /*!
+         * \brief
+         *      Create sink writing to an already opened file, which is left open (stdout, stderr, ...)
+         * \param file
+         *      Destination file
+         * \param flushInterval
+         *      Maximum time items wait in the backlog before being written
+         * \param maxBacklog
+         *      Maximum bytes waiting to be written. Items that don't fit are dropped (See Dropped())
+         */
+        explicit AsyncFileSink(std::FILE *file, std::chrono::milliseconds flushInterval = std::chrono::milliseconds(250),
+                               size_t maxBacklog = 4 * 1024 * 1024);
+
+        /*!
+         * \brief
+         *      Write remaining backlog and stop writer thread
+         */
+        ~AsyncFileSink() override;
+
+        AsyncFileSink(const AsyncFileSink &) = delete;
+        AsyncFileSink &operator=(const AsyncFileSink &) = delete;
+
+        /*!
+         * \brief
+         *      Add item to the backlog
+         * \param item
+         *      Logged item
+         */
+        void Write(const Item &item) override;
+
+        /*!
+         * \brief
+         *      Add a "(xN)" repeat count line to the backlog
+         * \param item
+         *      Written item
+         */
+        void Repeated(const Item &item) override;
+
+        /*!
+         * \brief
+         *      Block until the backlog has been written, or failed to be (See WriteErrors())
+         */
+        void Flush() override;
+
+        /*!
+         * \return
+         *      True if the destination file could be opened
+         */
+        [[nodiscard]] bool IsOpen() const;
+
+        /*!
+         * \return
+         *      Items dropped because the backlog was full
+         */
+        [[nodiscard]] size_t Dropped() const;
+
+        /*!
+         * \return
+         *      Batches that didn't fully reach the destination, because writing or flushing it failed (Disk full)
+         */
+        [[nodiscard]] size_t WriteErrors() const;
+
+    protected:
+        void Start();                                 //!< Start writer thread
+        void Queue(std::string_view text);            //!< Add a line to the backlog
+        void Run();                                   //!< Writer thread loop
+
+        std::FILE *m_File = nullptr;                  //!< Destination
+        bool m_OwnsFile = false;                      //!< Close destination on destruction
+        std::chrono::milliseconds m_FlushInterval;    //!< Maximum time between writes
+        size_t m_MaxBacklog;                          //!< Backlog size limit
+
+        mutable std::mutex m_Mutex;                   //!< Guards everything below
+        std::condition_variable m_Wake;               //!< Wakes writer thread
+        std::condition_variable m_Written;            //!< Signals a batch was written
+        std::string m_Backlog;                        //!< Text waiting to be written
+        size_t m_Requested = 0;                       //!< Flush requests
+        size_t m_Completed = 0;                       //!< Flush requests served
+        size_t m_Dropped = 0;                         //!< Items dropped
+        size_t m_WriteErrors = 0;                     //!< Batches that failed to be written
+        bool m_Stop = false;                          //!< Writer thread must exit
+        std::thread m_Thread;                         //!< Writer thread
+    };
+}
+
+#ifdef CSYS_HEADER_ONLY
+#include "csys/sink.inl"
+#endif
+
+#endif //CSYS_SINK_H
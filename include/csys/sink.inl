@@ -0,0 +1,166 @@
+// Copyright (c) 2020-present, Roland Munguia & Tristan Florian Bouchard.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#ifndef CSYS_HEADER_ONLY
+
+#include "csys/sink.h"
+
+#endif
+
+namespace csys
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Public methods /////////////////////////////////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    CSYS_INLINE AsyncFileSink::AsyncFileSink(const std::string &path, std::chrono::milliseconds flushInterval, size_t maxBacklog)
+            : m_OwnsFile(true), m_FlushInterval(flushInterval), m_MaxBacklog(maxBacklog)
+    {
+// Disable warning regarding fopen when using MVSC
+#pragma warning( push )
+#pragma warning( disable:4996 )
+        m_File = std::fopen(path.c_str(), "wb");
+#pragma warning( pop )
+        Start();
+    }
+
+    CSYS_INLINE AsyncFileSink::AsyncFileSink(std::FILE *file, std::chrono::milliseconds flushInterval, size_t maxBacklog)
+            : m_File(file), m_FlushInterval(flushInterval), m_MaxBacklog(maxBacklog)
+    {
+        Start();
+    }
+
+    CSYS_INLINE AsyncFileSink::~AsyncFileSink()
+    {
+        if (m_Thread.joinable())
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                m_Stop = true;
+            }
+            m_Wake.notify_one();
+            m_Thread.join();
+        }
+
+        if (m_File && m_OwnsFile)
+            std::fclose(m_File);
+    }
+
+    CSYS_INLINE void AsyncFileSink::Write(const Item &item)
+    {
+        if (!m_File || item.m_Type == NONE)
+            return;
+
+        Queue(item.View());
+    }
+
+    CSYS_INLINE void AsyncFileSink::Repeated(const Item &item)
+    {
+        if (!m_File || item.m_Type == NONE)
+            return;
+
+        char count[32];
+        int size = std::snprintf(count, sizeof(count), "(x%u)", item.m_Repeat);
+        Queue(std::string_view(count, static_cast<size_t>(size)));
+    }
+
+    CSYS_INLINE void AsyncFileSink::Flush()
+    {
+        if (!m_Thread.joinable())
+            return;
+
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        size_t request = ++m_Requested;
+        m_Wake.notify_one();
+        m_Written.wait(lock, [&]
+        { return m_Completed >= request; });
+    }
+
+    CSYS_INLINE bool AsyncFileSink::IsOpen() const
+    {
+        return m_File != nullptr;
+    }
+
+    CSYS_INLINE size_t AsyncFileSink::Dropped() const
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        return m_Dropped;
+    }
+
+    CSYS_INLINE size_t AsyncFileSink::WriteErrors() const
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        return m_WriteErrors;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Private methods ////////////////////////////////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    CSYS_INLINE void AsyncFileSink::Start()
+    {
+        if (m_File)
+            m_Thread = std::thread(&AsyncFileSink::Run, this);
+    }
+
+    CSYS_INLINE void AsyncFileSink::Queue(std::string_view text)
+    {
+        // One item per line.
+        bool new_line = text.empty() || text.back() != '\n';
+
+        bool wake;
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            if (m_Backlog.size() + text.size() + new_line > m_MaxBacklog)
+            {
+                ++m_Dropped;
+                return;
+            }
+
+            m_Backlog.append(text);
+            if (new_line) m_Backlog.push_back('\n');
+            wake = m_Backlog.size() >= m_MaxBacklog / 2;
+        }
+
+        // Write early when backlog is getting full.
+        if (wake)
+            m_Wake.notify_one();
+    }
+
+    CSYS_INLINE void AsyncFileSink::Run()
+    {
+        // Backlog and batch are swapped, so both buffers keep their capacity.
+        std::string batch;
+
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        for (;;)
+        {
+            m_Wake.wait_for(lock, m_FlushInterval, [&]
+            { return m_Stop || m_Requested != m_Completed || m_Backlog.size() >= m_MaxBacklog / 2; });
+
+            size_t request = m_Requested;
+            bool stop = m_Stop;
+            batch.swap(m_Backlog);
+
+            // Write whole batch at once, without holding the logging thread.
+            lock.unlock();
+            bool failed = false;
+            if (!batch.empty())
+            {
+                failed = std::fwrite(batch.data(), 1, batch.size(), m_File) != batch.size();
+                failed = std::fflush(m_File) != 0 || failed;
+                batch.clear();
+            }
+            lock.lock();
+
+            // Completed flush requests report failures through WriteErrors().
+            m_WriteErrors += failed;
+            m_Completed = request;
+            m_Written.notify_all();
+            if (stop)
+                break;
+        }
+    }
+}
@@ -0,0 +1,166 @@
+// Copyright (c) 2020-present, Roland Munguia & Tristan Florian Bouchard.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#ifndef CSYS_SPILL_FILE_H
+#define CSYS_SPILL_FILE_H
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include "csys/api.h"
+
+namespace csys
+{
+    /*!
+     * \brief
+     *      Append-only on-disk storage for console items evicted from a capped ItemLog.
+     *      Items are stored line by line in a data file, with a fixed size entry per line in an index file
+     *      (<path>.idx). Both files are memory mapped for reading, so only the pages that are viewed are touched and
+     *      RAM use doesn't depend on how much has been spilled.
+     */
+    class CSYS_API SpillFile
+    {
+    public:
+
+        /*!
+         * \brief
+         *      Spilled line
+         */
+        struct Line
+        {
+            std::string_view m_Text;    //!< Line text (First line of an item includes its style prefix)
+            int m_Type;                 //!< ItemType of the item the line belongs to
+        };
+
+        SpillFile() = default;
+
+        /*!
+         * \brief
+         *      Close files
+         */
+        ~SpillFile();
+
+        /*!
+         * \brief
+         *      Move constructor
+         * \param rhs
+         *      Spill file to be moved.
+         */
+        SpillFile(SpillFile &&rhs) noexcept;
+
+        /*!
+         * \brief
+         *      Copy constructor. Files can only have one writer, so the copy is closed
+         * \param rhs
+         *      Spill file to be copied.
+         */
+        SpillFile(const SpillFile &rhs [[maybe_unused]])
+        {}
+
+        /*!
+         * \brief
+         *      Move assignment operator
+         * \param rhs
+         *      Spill file to be moved.
+         */
+        SpillFile &operator=(SpillFile &&rhs) noexcept;
+
+        /*!
+         * \brief
+         *      Copy assignment operator. Closes this file (See copy constructor)
+         * \param rhs
+         *      Spill file to be copied.
+         */
+        SpillFile &operator=(const SpillFile &rhs);
+
+        /*!
+         * \brief
+         *      Create (Or truncate) spill files
+         * \param path
+         *      Data file path. Index file is stored next to it with the .idx extension
+         * \return
+         *      False if files could not be created
+         */
+        bool Open(const std::string &path);
+
+        /*!
+         * \brief
+         *      Close spill files (They are left on disk)
+         */
+        void Close();
+
+        /*!
+         * \brief
+         *      Drop all spilled lines
+         */
+        void Clear();
+
+        /*!
+         * \return
+         *      True if spilling is enabled
+         */
+        [[nodiscard]] bool IsOpen() const;
+
+        /*!
+         * \brief
+         *      Write item to disk, one entry per line
+         * \param text
+         *      Stylized item text
+         * \param type
+         *      ItemType of the item
+         */
+        void Append(std::string_view text, int type);
+
+        /*!
+         * \return
+         *      Number of spilled lines
+         */
+        [[nodiscard]] size_t Size() const;
+
+        /*!
+         * \return
+         *      True if writing to the spill files failed (Disk full). Spilling stops, lines spilled before are kept
+         */
+        [[nodiscard]] bool Failed() const;
+
+        /*!
+         * \brief
+         *      Read spilled line from the mapped files (Mapping is extended if needed)
+         * \param index
+         *      Line index, 0 being the oldest
+         * \return
+         *      Line. Text stays valid until a line spilled after the current mapping is read
+         */
+        Line Get(size_t index);
+
+    protected:
+        struct Entry
+        {
+            uint64_t m_Offset;    //!< Offset of the line in the data file
+            uint32_t m_Size;      //!< Size of the line
+            uint32_t m_Type;      //!< ItemType of the line
+        };
+
+        void Map();        //!< Map everything written so far
+        void Unmap();      //!< Release mappings
+
+        std::string m_Path;                  //!< Data file path
+        std::FILE *m_Data = nullptr;         //!< Data file
+        std::FILE *m_Index = nullptr;        //!< Index file
+        uint64_t m_DataSize = 0;             //!< Bytes written to data file
+        size_t m_Count = 0;                  //!< Lines written
+        const char *m_DataMap = nullptr;     //!< Mapped data file
+        const Entry *m_IndexMap = nullptr;   //!< Mapped index file
+        uint64_t m_DataMapSize = 0;          //!< Bytes of data file mapped
+        size_t m_IndexMapCount = 0;          //!< Entries of index file mapped
+        bool m_Failed = false;               //!< A write failed, nothing more is spilled
+    };
+}
+
+#ifdef CSYS_HEADER_ONLY
+#include "csys/spill_file.inl"
+#endif
+
+#endif //CSYS_SPILL_FILE_H
@@ -0,0 +1,249 @@
+// Copyright (c) 2020-present, Roland Munguia & Tristan Florian Bouchard.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#ifndef CSYS_HEADER_ONLY
+
+#include "csys/spill_file.h"
+
+#endif
+
+#include <utility>
+
+// Macros defined here are undefined after <windows.h>, so they don't leak into user code in header-only builds.
+#if defined(_WIN32)
+#  ifndef WIN32_LEAN_AND_MEAN
+#    define WIN32_LEAN_AND_MEAN
+#    define CSYS_UNDEF_WIN32_LEAN_AND_MEAN
+#  endif
+#  ifndef NOMINMAX
+#    define NOMINMAX
+#    define CSYS_UNDEF_NOMINMAX
+#  endif
+#  ifndef NOGDI
+#    define NOGDI    // Defines ERROR, which clashes with csys::ERROR
+#    define CSYS_UNDEF_NOGDI
+#  endif
+#  include <windows.h>
+#  include <io.h>
+#  ifdef CSYS_UNDEF_WIN32_LEAN_AND_MEAN
+#    undef WIN32_LEAN_AND_MEAN
+#    undef CSYS_UNDEF_WIN32_LEAN_AND_MEAN
+#  endif
+#  ifdef CSYS_UNDEF_NOMINMAX
+#    undef NOMINMAX
+#    undef CSYS_UNDEF_NOMINMAX
+#  endif
+#  ifdef CSYS_UNDEF_NOGDI
+#    undef NOGDI
+#    undef CSYS_UNDEF_NOGDI
+#  endif
+#else
+#  include <sys/mman.h>
+#endif
+
+namespace csys
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Platform ///////////////////////////////////////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Map size bytes of file for reading.
+    static const void *SpillMap(std::FILE *file, uint64_t size)
+    {
+#if defined(_WIN32)
+        auto handle = reinterpret_cast<HANDLE>(_get_osfhandle(_fileno(file)));
+        HANDLE mapping = CreateFileMappingA(handle, nullptr, PAGE_READONLY, static_cast<DWORD>(size >> 32), static_cast<DWORD>(size), nullptr);
+        if (!mapping)
+            return nullptr;
+
+        // View keeps mapping alive.
+        void *view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, static_cast<SIZE_T>(size));
+        CloseHandle(mapping);
+        return view;
+#else
+        void *view = mmap(nullptr, static_cast<size_t>(size), PROT_READ, MAP_SHARED, fileno(file), 0);
+        return view == MAP_FAILED ? nullptr : view;
+#endif
+    }
+
+    static void SpillUnmap(const void *view, uint64_t size [[maybe_unused]])
+    {
+#if defined(_WIN32)
+        UnmapViewOfFile(view);
+#else
+        munmap(const_cast<void *>(view), static_cast<size_t>(size));
+#endif
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Public methods /////////////////////////////////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    CSYS_INLINE SpillFile::~SpillFile()
+    {
+        Close();
+    }
+
+    CSYS_INLINE SpillFile::SpillFile(SpillFile &&rhs) noexcept
+    {
+        *this = std::move(rhs);
+    }
+
+    CSYS_INLINE SpillFile &SpillFile::operator=(SpillFile &&rhs) noexcept
+    {
+        if (this == &rhs)
+            return *this;
+
+        Close();
+        m_Path = std::move(rhs.m_Path);
+        m_Data = std::exchange(rhs.m_Data, nullptr);
+        m_Index = std::exchange(rhs.m_Index, nullptr);
+        m_DataSize = std::exchange(rhs.m_DataSize, 0);
+        m_Count = std::exchange(rhs.m_Count, 0);
+        m_DataMap = std::exchange(rhs.m_DataMap, nullptr);
+        m_IndexMap = std::exchange(rhs.m_IndexMap, nullptr);
+        m_DataMapSize = std::exchange(rhs.m_DataMapSize, 0);
+        m_IndexMapCount = std::exchange(rhs.m_IndexMapCount, 0);
+        m_Failed = std::exchange(rhs.m_Failed, false);
+        return *this;
+    }
+
+    CSYS_INLINE SpillFile &SpillFile::operator=(const SpillFile &rhs)
+    {
+        if (this != &rhs)
+            Close();
+        return *this;
+    }
+
+    CSYS_INLINE bool SpillFile::Open(const std::string &path)
+    {
+        Close();
+
+// Disable warning regarding fopen when using MVSC
+#pragma warning( push )
+#pragma warning( disable:4996 )
+        m_Data = std::fopen(path.c_str(), "wb+");
+        m_Index = std::fopen((path + ".idx").c_str(), "wb+");
+#pragma warning( pop )
+
+        if (!m_Data || !m_Index)
+        {
+            Close();
+            return false;
+        }
+
+        m_Path = path;
+        m_Failed = false;
+        return true;
+    }
+
+    CSYS_INLINE void SpillFile::Close()
+    {
+        Unmap();
+        if (m_Data) std::fclose(m_Data);
+        if (m_Index) std::fclose(m_Index);
+        m_Data = m_Index = nullptr;
+        m_DataSize = 0;
+        m_Count = 0;
+    }
+
+    CSYS_INLINE void SpillFile::Clear()
+    {
+        if (IsOpen())
+            Open(std::string(m_Path));
+    }
+
+    CSYS_INLINE bool SpillFile::IsOpen() const
+    {
+        return m_Data != nullptr;
+    }
+
+    CSYS_INLINE void SpillFile::Append(std::string_view text, int type)
+    {
+        if (!IsOpen() || m_Failed)
+            return;
+
+        // One entry per line, so history can be displayed with fixed line heights.
+        do
+        {
+            size_t end = text.find('\n');
+            std::string_view line = text.substr(0, end);
+
+            // Lines that didn't make it to disk aren't counted, and nothing is written after them. (Disk full)
+            Entry entry{m_DataSize, static_cast<uint32_t>(line.size()), static_cast<uint32_t>(type)};
+            if (std::fwrite(line.data(), 1, line.size(), m_Data) != line.size() || std::fwrite(&entry, sizeof(entry), 1, m_Index) != 1)
+            {
+                m_Failed = true;
+                return;
+            }
+            m_DataSize += line.size();
+            ++m_Count;
+
+            // Trailing new line doesn't start another line.
+            text = end == std::string_view::npos || end + 1 == text.size() ? std::string_view() : text.substr(end + 1);
+        } while (!text.empty());
+    }
+
+    CSYS_INLINE size_t SpillFile::Size() const
+    {
+        return m_Count;
+    }
+
+    CSYS_INLINE bool SpillFile::Failed() const
+    {
+        return m_Failed;
+    }
+
+    CSYS_INLINE SpillFile::Line SpillFile::Get(size_t index)
+    {
+        if (index >= m_IndexMapCount)
+            Map();
+
+        // Mapping failed.
+        if (!m_IndexMap || !m_DataMap || index >= m_IndexMapCount)
+            return Line{std::string_view(), 0};
+
+        const Entry &entry = m_IndexMap[index];
+        return Line{std::string_view(m_DataMap + entry.m_Offset, entry.m_Size), static_cast<int>(entry.m_Type)};
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Private methods ////////////////////////////////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    CSYS_INLINE void SpillFile::Map()
+    {
+        // Make buffered writes visible to the mapping. Lines that couldn't be written are forgotten, the current mapping
+        // stays valid.
+        if (std::fflush(m_Data) != 0 || std::fflush(m_Index) != 0)
+        {
+            m_Failed = true;
+            m_DataSize = m_DataMapSize;
+            m_Count = m_IndexMapCount;
+            return;
+        }
+
+        Unmap();
+
+        // Empty lines don't write data, but still need a valid pointer.
+        static const char s_Empty = '\0';
+        m_DataMap = m_DataSize ? static_cast<const char *>(SpillMap(m_Data, m_DataSize)) : &s_Empty;
+        m_IndexMap = static_cast<const Entry *>(SpillMap(m_Index, m_Count * sizeof(Entry)));
+        m_DataMapSize = m_DataSize;
+        m_IndexMapCount = m_Count;
+    }
+
+    CSYS_INLINE void SpillFile::Unmap()
+    {
+        if (m_DataMap && m_DataMapSize)
+            SpillUnmap(m_DataMap, m_DataMapSize);
+        if (m_IndexMap)
+            SpillUnmap(m_IndexMap, m_IndexMapCount * sizeof(Entry));
+        m_DataMap = nullptr;
+        m_IndexMap = nullptr;
+        m_DataMapSize = 0;
+        m_IndexMapCount = 0;
+    }
+}
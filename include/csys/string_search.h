@@ -0,0 +1,64 @@
+// Copyright (c) 2020-present, Roland Munguia & Tristan Florian Bouchard.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#ifndef CSYS_STRING_SEARCH_H
+#define CSYS_STRING_SEARCH_H
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+#include "csys/api.h"
+
+// Vectorized search, picked at compile time. (AVX2 requires compiling with it enabled, e.g. -mavx2 or /arch:AVX2)
+#if defined(__AVX2__)
+#  define CSYS_SEARCH_AVX2
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  define CSYS_SEARCH_SSE2
+#endif
+
+namespace csys
+{
+    /*!
+     * \brief
+     *      ASCII lower case
+     * \param c
+     *      Character
+     * \return
+     *      Lower case character, or c if it isn't an upper case ASCII letter
+     */
+    constexpr char ToLowerAscii(char c)
+    {
+        return c >= 'A' && c <= 'Z' ? static_cast<char>(c + ('a' - 'A')) : c;
+    }
+
+    /*!
+     * \brief
+     *      Find a substring (SSE2/AVX2 when available, scalar otherwise)
+     * \param haystack
+     *      Text to search
+     * \param needle
+     *      Substring to look for
+     * \return
+     *      Position of the first occurrence, or std::string_view::npos
+     */
+    CSYS_API size_t Find(std::string_view haystack, std::string_view needle);
+
+    /*!
+     * \brief
+     *      Find a substring, ignoring ASCII case (SSE2/AVX2 when available, scalar otherwise)
+     * \param haystack
+     *      Text to search
+     * \param needle
+     *      Substring to look for
+     * \return
+     *      Position of the first occurrence, or std::string_view::npos
+     */
+    CSYS_API size_t FindCaseInsensitive(std::string_view haystack, std::string_view needle);
+}
+
+#ifdef CSYS_HEADER_ONLY
+#include "csys/string_search.inl"
+#endif
+
+#endif //CSYS_STRING_SEARCH_H
@@ -0,0 +1,172 @@
+// Copyright (c) 2020-present, Roland Munguia & Tristan Florian Bouchard.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#ifndef CSYS_HEADER_ONLY
+
+#include "csys/string_search.h"
+
+#endif
+
+#include <cstdint>
+#include <cstring>
+
+#if defined(CSYS_SEARCH_AVX2) || defined(CSYS_SEARCH_SSE2)
+#  include <immintrin.h>
+#endif
+#if defined(_MSC_VER)
+#  include <intrin.h>
+#endif
+
+namespace csys
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Helpers ////////////////////////////////////////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Compare n characters, optionally ignoring ASCII case.
+    template<bool Fold>
+    static bool SearchEqual(const char *a, const char *b, size_t n)
+    {
+        if constexpr (!Fold)
+            return std::memcmp(a, b, n) == 0;
+
+        for (size_t i = 0; i < n; ++i)
+            if (ToLowerAscii(a[i]) != ToLowerAscii(b[i]))
+                return false;
+        return true;
+    }
+
+    template<bool Fold>
+    static size_t SearchScalar(std::string_view haystack, std::string_view needle)
+    {
+        if constexpr (!Fold)
+            return haystack.find(needle);
+
+        if (needle.size() > haystack.size())
+            return std::string_view::npos;
+
+        const char first = ToLowerAscii(needle[0]);
+        for (size_t i = 0; i + needle.size() <= haystack.size(); ++i)
+            if (ToLowerAscii(haystack[i]) == first && SearchEqual<true>(haystack.data() + i + 1, needle.data() + 1, needle.size() - 1))
+                return i;
+        return std::string_view::npos;
+    }
+
+    static unsigned SearchLowestBit(uint32_t mask)
+    {
+#if defined(_MSC_VER)
+        unsigned long bit;
+        _BitScanForward(&bit, mask);
+        return static_cast<unsigned>(bit);
+#else
+        return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+    }
+
+#if defined(CSYS_SEARCH_AVX2)
+    struct SearchAvx2
+    {
+        using Vec = __m256i;
+        static constexpr size_t s_Width = 32;
+
+        static Vec Load(const char *p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p)); }
+        static Vec Set(char c) { return _mm256_set1_epi8(c); }
+        static uint32_t Match(Vec a, Vec b, Vec first, Vec last)
+        { return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(a, first), _mm256_cmpeq_epi8(b, last)))); }
+
+        // 'A'..'Z' moved to the bottom of the signed range, so one compare finds upper case letters.
+        static Vec Fold(Vec v)
+        {
+            Vec upper = _mm256_cmpgt_epi8(Set(static_cast<char>(-128 + 26)), _mm256_add_epi8(v, Set(static_cast<char>(128 - 'A'))));
+            return _mm256_add_epi8(v, _mm256_and_si256(upper, Set(0x20)));
+        }
+    };
+#endif
+
+#if defined(CSYS_SEARCH_SSE2)
+    struct SearchSse2
+    {
+        using Vec = __m128i;
+        static constexpr size_t s_Width = 16;
+
+        static Vec Load(const char *p) { return _mm_loadu_si128(reinterpret_cast<const __m128i *>(p)); }
+        static Vec Set(char c) { return _mm_set1_epi8(c); }
+        static uint32_t Match(Vec a, Vec b, Vec first, Vec last)
+        { return static_cast<uint32_t>(_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(a, first), _mm_cmpeq_epi8(b, last)))); }
+
+        // 'A'..'Z' moved to the bottom of the signed range, so one compare finds upper case letters.
+        static Vec Fold(Vec v)
+        {
+            Vec upper = _mm_cmplt_epi8(_mm_add_epi8(v, Set(static_cast<char>(128 - 'A'))), Set(static_cast<char>(-128 + 26)));
+            return _mm_add_epi8(v, _mm_and_si128(upper, Set(0x20)));
+        }
+    };
+#endif
+
+    // Compare the first and last needle characters against a whole block of candidate positions at once, and only
+    // check the rest of the needle where both match.
+    template<typename Simd, bool Fold>
+    static size_t SearchVector(std::string_view haystack, std::string_view needle)
+    {
+        const size_t n = needle.size();
+        const char *text = haystack.data();
+        const auto first = Simd::Set(Fold ? ToLowerAscii(needle.front()) : needle.front());
+        const auto last = Simd::Set(Fold ? ToLowerAscii(needle.back()) : needle.back());
+
+        size_t i = 0;
+        for (; i + n - 1 + Simd::s_Width <= haystack.size(); i += Simd::s_Width)
+        {
+            auto a = Simd::Load(text + i);
+            auto b = Simd::Load(text + i + n - 1);
+            if constexpr (Fold)
+            {
+                a = Simd::Fold(a);
+                b = Simd::Fold(b);
+            }
+
+            for (uint32_t mask = Simd::Match(a, b, first, last); mask; mask &= mask - 1)
+            {
+                size_t pos = i + SearchLowestBit(mask);
+                if (n <= 2 || SearchEqual<Fold>(text + pos + 1, needle.data() + 1, n - 2))
+                    return pos;
+            }
+        }
+
+        // Remaining positions.
+        size_t pos = SearchScalar<Fold>(haystack.substr(i), needle);
+        return pos == std::string_view::npos ? pos : i + pos;
+    }
+
+    template<bool Fold>
+    static size_t Search(std::string_view haystack, std::string_view needle)
+    {
+        if (needle.empty())
+            return 0;
+        if (needle.size() > haystack.size())
+            return std::string_view::npos;
+
+#if defined(CSYS_SEARCH_AVX2)
+        return SearchVector<SearchAvx2, Fold>(haystack, needle);
+#elif defined(CSYS_SEARCH_SSE2)
+        return SearchVector<SearchSse2, Fold>(haystack, needle);
+#else
+        return SearchScalar<Fold>(haystack, needle);
+#endif
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Public methods /////////////////////////////////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    CSYS_INLINE size_t Find(std::string_view haystack, std::string_view needle)
+    {
+        return Search<false>(haystack, needle);
+    }
+
+    CSYS_INLINE size_t FindCaseInsensitive(std::string_view haystack, std::string_view needle)
+    {
+        return Search<true>(haystack, needle);
+    }
+}
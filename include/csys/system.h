@@ -14,6 +14,7 @@
 #include <memory>
 #include <unordered_map>
 #include <string>
+#include <string_view>
 
 namespace csys
 {
@@ -96,7 +97,15 @@ namespace csys
          * \return
          *      Console items container
          */
-        std::vector<Item> &Items();
+        RingBuffer<Item> &Items();
+
+        /*!
+         * \brief
+         *      Get console item log (To configure capacity limits, post items from other threads, etc)
+         * \return
+         *      Console item log
+         */
+        ItemLog &Logger();
 
         /*!
          * \brief
@@ -108,6 +117,60 @@ namespace csys
          */
         ItemLog &Log(ItemType type = ItemType::LOG);
 
+        /*!
+         * \brief
+         *      Creates a new item entry from a format string. ("hp={} pos={:.2f}", hp, pos)
+         * \param type
+         *      Log type (COMMAND, LOG, WARNING, ERROR)
+         * \param fmt
+         *      Format string, checked against the arguments at compile time (C++20, or CSYS_FMT) or construction (C++17)
+         * \param args
+         *      Arguments matching the format string fields, in order
+         * \return
+         *      Reference to console items obj
+         */
+        template<typename ...Args>
+        ItemLog &Log(ItemType type, FormatString<typename TypeIdentity<Args>::type...> fmt, Args &&...args)
+        {
+            return m_ItemLog.log(type, fmt, std::forward<Args>(args)...);
+        }
+
+        /*!
+         * \brief
+         *      Creates a new item entry that is only formatted when displayed. The call only copies the arguments
+         * \param type
+         *      Log type (COMMAND, LOG, WARNING, ERROR)
+         * \param fmt
+         *      Format string literal (See Log(type, fmt, args...)). Copied into the record unless checked at compile time
+         * \param args
+         *      Trivially copyable or string arguments matching the format string fields, in order
+         * \return
+         *      Reference to console items obj
+         */
+        template<typename ...Args>
+        ItemLog &Defer(ItemType type, FormatString<typename TypeIdentity<Args>::type...> fmt, Args &&...args)
+        {
+            return m_ItemLog.Defer(type, fmt, std::forward<Args>(args)...);
+        }
+
+        /*!
+         * \brief
+         *      Queue an item to be logged from any thread (Lock-free)
+         * \param type
+         *      Log type (COMMAND, LOG, WARNING, ERROR)
+         * \param str
+         *      Item data
+         */
+        void Post(ItemType type, std::string_view str);
+
+        /*!
+         * \brief
+         *      Move items posted from other threads into the console log. Call once per frame from the main thread
+         * \return
+         *      Number of items drained
+         */
+        size_t Drain();
+
         /*!
          * \brief
          *      Run the given script
@@ -332,7 +395,7 @@ namespace csys
             return var_name;
         }
 
-        void ParseCommandLine(const String &line);                                   //!< Parse command line and execute command
+        void ParseCommandLine(std::string_view line);                                //!< Parse command line and execute command
 
         std::unordered_map<std::string, std::unique_ptr<CommandBase>> m_Commands;    //!< Registered command container
         AutoComplete m_CommandSuggestionTree;                                        //!< Autocomplete Ternary Search Tree for commands
@@ -341,6 +404,8 @@ namespace csys
         ItemLog m_ItemLog;                                                           //!< Console Items (Logging)
         std::unordered_map<std::string, std::unique_ptr<Script>> m_Scripts;          //!< Scripts
         bool m_RegisterCommandSuggestion = true;                                     //!< Flag that determines if commands will be registered for autocomplete.
+        std::string m_CommandName;                                                   //!< Name of the command being parsed (Reused between commands)
+        String m_CommandArguments;                                                   //!< Arguments of the command being run (Reused between commands)
     };
 }
 
@@ -22,6 +22,17 @@ namespace csys
     static const std::string_view s_ErrorNoVar = "No variable provided";
     static const std::string_view s_ErrorSetGetNotFound = "Command doesn't exist and/or variable is not registered";
 
+    // Next whitespace separated token of a command line, viewed in place. (Empty at the end of the line)
+    static std::string_view NextToken(std::string_view line, size_t &pos)
+    {
+        while (pos < line.size() && std::isspace(static_cast<unsigned char>(line[pos])))
+            ++pos;
+        size_t begin = pos;
+        while (pos < line.size() && !std::isspace(static_cast<unsigned char>(line[pos])))
+            ++pos;
+        return line.substr(begin, pos - begin);
+    }
+
     CSYS_INLINE System::System()
     {
         // Register help command.
@@ -109,8 +120,10 @@ namespace csys
         // Log command.
         Log(csys::ItemType::COMMAND) << line << csys::endl;
 
-        // Parse command line.
+        // Parse command line. (Items logged meanwhile are the command output)
+        m_ItemLog.BeginGroup();
         ParseCommandLine(line);
+        m_ItemLog.EndGroup();
     }
 
     CSYS_INLINE void System::RunScript(const std::string &script_name)
@@ -225,10 +238,16 @@ namespace csys
 
     CSYS_INLINE CommandHistory &System::History() { return m_CommandHistory; }
 
-    CSYS_INLINE std::vector<Item> &System::Items() { return m_ItemLog.Items(); }
+    CSYS_INLINE RingBuffer<Item> &System::Items() { return m_ItemLog.Items(); }
+
+    CSYS_INLINE ItemLog &System::Logger() { return m_ItemLog; }
 
     CSYS_INLINE ItemLog &System::Log(ItemType type) { return m_ItemLog.log(type); }
 
+    CSYS_INLINE void System::Post(ItemType type, std::string_view str) { m_ItemLog.Post(type, str); }
+
+    CSYS_INLINE size_t System::Drain() { return m_ItemLog.Drain(); }
+
     CSYS_INLINE std::unordered_map<std::string, std::unique_ptr<CommandBase>> &System::Commands() { return m_Commands; }
 
     CSYS_INLINE std::unordered_map<std::string, std::unique_ptr<Script>> &System::Scripts() { return m_Scripts; }
@@ -237,64 +256,63 @@ namespace csys
     // Private methods ////////////////////////////////////////////////////////
     ///////////////////////////////////////////////////////////////////////////
 
-    CSYS_INLINE void System::ParseCommandLine(const String &line)
+    CSYS_INLINE void System::ParseCommandLine(std::string_view line)
     {
-        // Get first non-whitespace char.
-        size_t line_index = 0;
-        std::pair<size_t, size_t> range = line.NextPoi(line_index);
+        // Tokens are views over the line, text is only copied into buffers reused between commands.
+        size_t pos = 0;
+        std::string_view name = NextToken(line, pos);
 
         // Just whitespace was passed in. Don't log as command.
-        if (range.first == line.End())
+        if (name.empty())
             return;
 
         // Push to history.
-        m_CommandHistory.PushBack(line.m_String);
-
-        // Get name of command.
-        std::string command_name = line.m_String.substr(range.first, range.second - range.first);
+        m_CommandHistory.PushBack(line);
 
         // Set or get
-        bool is_cmd_set = command_name == s_Set;
-        bool is_cmd_get = command_name == s_Get;
-        bool is_cmd_help = !(is_cmd_set || is_cmd_get) ? command_name == s_Help : false;
+        bool is_cmd_set = name == s_Set;
+        bool is_cmd_get = name == s_Get;
+        bool is_cmd_help = !(is_cmd_set || is_cmd_get) ? name == s_Help : false;
+        m_CommandName.assign(name.data(), name.size());
 
         // Edge case for if user is just runs "help" command
         if (is_cmd_help)
         {
-            range = line.NextPoi(line_index);
-            if (range.first != line.End())
-                command_name += " " + line.m_String.substr(range.first, range.second - range.first);
+            std::string_view topic = NextToken(line, pos);
+            if (!topic.empty())
+                m_CommandName.append(1, ' ').append(topic.data(), topic.size());
         }
 
             // Its a set or get command
         else if (is_cmd_set || is_cmd_get)
         {
             // Try to get variable name
-            if ((range = line.NextPoi(line_index)).first == line.End())
+            std::string_view variable = NextToken(line, pos);
+            if (variable.empty())
             {
                 Log(ERROR) << s_ErrorNoVar << endl;
                 return;
             } else
                 // Append variable name.
-                command_name += " " + line.m_String.substr(range.first, range.second - range.first);
+                m_CommandName.append(1, ' ').append(variable.data(), variable.size());
         }
 
         // Get runnable command
-        auto command = m_Commands.find(command_name);
+        auto command = m_Commands.find(m_CommandName);
         if (command == m_Commands.end())
             Log(ERROR) << s_ErrorSetGetNotFound << endl;
             // Run the command
         else
         {
-            // Get the arguments.
-            String arguments = line.m_String.substr(range.second, line.m_String.size() - range.first);
+            // Get the arguments. (Parsed before the command function runs, so nested commands may reuse the buffer)
+            m_CommandArguments.m_String.assign(line.data() + pos, line.size() - pos);
 
             // Execute command.
-            auto cmd_out = (*command->second)(arguments);
+            auto cmd_out = (*command->second)(m_CommandArguments);
 
             // Log output.
             if (cmd_out.m_Type != NONE)
-                m_ItemLog.Items().emplace_back(cmd_out);
+                m_ItemLog.log(std::move(cmd_out));
         }
     }
 }
\ No newline at end of file
@@ -0,0 +1,174 @@
+// Copyright (c) 2020-present, Roland Munguia & Tristan Florian Bouchard.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#ifndef CSYS_TEXT_ARENA_H
+#define CSYS_TEXT_ARENA_H
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
+#include "csys/api.h"
+#include "csys/ring_buffer.h"
+
+namespace csys
+{
+    /*!
+     * \brief
+     *      Append-only text storage made of large chunks. Blocks never move once written (Unless grown past their
+     *      chunk), so views into the arena stay valid until their block is released.
+     *      Chunks are reference counted by the blocks inside them and freed as soon as all of them are released. The
+     *      last freed chunk of the default size is kept for the next one, so a log cycling through chunks doesn't allocate.
+     */
+    class CSYS_API TextArena
+    {
+    public:
+
+        static constexpr uint32_t s_NoChunk = ~uint32_t(0);    //!< Chunk id of blocks not living in an arena
+
+        /*!
+         * \brief
+         *      Create empty arena
+         * \param chunkSize
+         *      Size of every chunk allocation. (Blocks bigger than this get a chunk of their own)
+         */
+        explicit TextArena(size_t chunkSize = 64 * 1024);
+
+        /*!
+         * \brief
+         *      Move constructor
+         * \param rhs
+         *      Arena to be moved.
+         */
+        TextArena(TextArena &&rhs) = default;
+
+        /*!
+         * \brief
+         *      Copy constructor. Blocks are owned by whoever holds views into them, so an empty arena is created.
+         * \param rhs
+         *      Arena to be copied.
+         */
+        TextArena(const TextArena &rhs);
+
+        /*!
+         * \brief
+         *      Move assignment operator
+         * \param rhs
+         *      Arena to be moved.
+         */
+        TextArena &operator=(TextArena &&rhs) = default;
+
+        /*!
+         * \brief
+         *      Copy assignment operator. Releases all blocks (See copy constructor)
+         * \param rhs
+         *      Arena to be copied.
+         */
+        TextArena &operator=(const TextArena &rhs);
+
+        /*!
+         * \brief
+         *      Store a new block
+         * \param text
+         *      Block contents
+         * \param chunk
+         *      Receives the id of the chunk holding the block
+         * \return
+         *      Stored block
+         */
+        char *Append(std::string_view text, uint32_t &chunk);
+
+        /*!
+         * \brief
+         *      Grow a block. Done in place if the block is the last one of the newest chunk, otherwise the block is
+         *      copied to the newest chunk (With slack, so repeated growth is amortized)
+         * \param data
+         *      Block to grow
+         * \param size
+         *      Current block size
+         * \param extra
+         *      Bytes to add. (Left uninitialized at data + size)
+         * \param chunk
+         *      Chunk id of the block, updated if the block moves
+         * \return
+         *      Grown block
+         */
+        char *Grow(const char *data, size_t size, size_t extra, uint32_t &chunk);
+
+        /*!
+         * \brief
+         *      Give back unused bytes at the end of a block. (Only reclaimed if the block is the newest one)
+         * \param data
+         *      Block to shrink
+         * \param size
+         *      Current block size
+         * \param unused
+         *      Bytes to remove from the end of the block
+         * \param chunk
+         *      Chunk id of the block
+         */
+        void Shrink(const char *data, size_t size, size_t unused, uint32_t chunk);
+
+        /*!
+         * \brief
+         *      Release a block. Its chunk is freed once no blocks reference it
+         * \param chunk
+         *      Chunk id of the block
+         */
+        void Release(uint32_t chunk);
+
+        /*!
+         * \brief
+         *      Free all chunks. (Invalidates every block)
+         */
+        void Clear();
+
+        /*!
+         * \brief
+         *      Keep released blocks readable, for readers on other threads. Until unpinned, chunk memory isn't freed
+         *      or reused (Pins nest)
+         */
+        void Pin();
+
+        /*!
+         * \brief
+         *      Undo Pin(). Memory kept alive by the last pin is freed
+         */
+        void Unpin();
+
+        /*!
+         * \return
+         *      Bytes currently allocated by the arena
+         */
+        [[nodiscard]] size_t Capacity() const;
+
+    protected:
+        struct Chunk
+        {
+            std::unique_ptr<char[]> m_Data;    //!< Chunk memory (Null once freed)
+            size_t m_Size = 0;                 //!< Chunk capacity
+            size_t m_Used = 0;                 //!< Bytes written
+            size_t m_Refs = 0;                 //!< Live blocks inside chunk
+        };
+
+        char *Allocate(size_t size, size_t reserve, uint32_t &chunk);    //!< Bump allocate from the newest chunk (New chunk if it doesn't fit)
+        void Free(Chunk &chunk);                                         //!< Free chunk memory
+        Chunk &Get(uint32_t chunk);                                      //!< Chunk from id
+        [[nodiscard]] uint32_t Newest() const;                           //!< Id of the newest chunk
+
+        RingBuffer<Chunk> m_Chunks;    //!< Chunks, oldest first
+        uint32_t m_First = 0;          //!< Id of m_Chunks.front()
+        size_t m_ChunkSize;            //!< Default chunk allocation size
+        size_t m_Capacity = 0;         //!< Bytes allocated
+        size_t m_Pins = 0;             //!< Active pins
+        std::vector<std::unique_ptr<char[]>> m_Pinned;    //!< Freed chunk memory kept alive by pins
+        std::unique_ptr<char[]> m_Spare;                  //!< Freed chunk memory of the default size, reused by the next chunk
+    };
+}
+
+#ifdef CSYS_HEADER_ONLY
+#include "csys/text_arena.inl"
+#endif
+
+#endif //CSYS_TEXT_ARENA_H
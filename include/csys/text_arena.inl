@@ -0,0 +1,193 @@
+// Copyright (c) 2020-present, Roland Munguia & Tristan Florian Bouchard.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#ifndef CSYS_HEADER_ONLY
+
+#include "csys/text_arena.h"
+
+#endif
+
+#include <algorithm>
+#include <cstring>
+
+namespace csys
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Public methods /////////////////////////////////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    CSYS_INLINE TextArena::TextArena(size_t chunkSize) : m_ChunkSize(chunkSize)
+    {
+    }
+
+    CSYS_INLINE TextArena::TextArena(const TextArena &rhs) : m_ChunkSize(rhs.m_ChunkSize)
+    {
+    }
+
+    CSYS_INLINE TextArena &TextArena::operator=(const TextArena &rhs)
+    {
+        if (this == &rhs)
+            return *this;
+
+        Clear();
+        m_ChunkSize = rhs.m_ChunkSize;
+        return *this;
+    }
+
+    CSYS_INLINE char *TextArena::Append(std::string_view text, uint32_t &chunk)
+    {
+        char *block = Allocate(text.size(), text.size(), chunk);
+        if (!text.empty())
+            std::memcpy(block, text.data(), text.size());
+        ++Get(chunk).m_Refs;
+        return block;
+    }
+
+    CSYS_INLINE char *TextArena::Grow(const char *data, size_t size, size_t extra, uint32_t &chunk)
+    {
+        // Grow in place if block is at the tail of the newest chunk.
+        if (!m_Chunks.empty() && chunk == Newest())
+        {
+            Chunk &newest = m_Chunks.back();
+            if (data + size == newest.m_Data.get() + newest.m_Used && newest.m_Used + extra <= newest.m_Size)
+            {
+                newest.m_Used += extra;
+                return const_cast<char *>(data);
+            }
+        }
+
+        // Move block, reserving twice its size so it can keep growing in place.
+        uint32_t moved_chunk;
+        char *block = Allocate(size + extra, (size + extra) * 2, moved_chunk);
+        if (size)
+            std::memcpy(block, data, size);
+        ++Get(moved_chunk).m_Refs;
+
+        if (chunk != s_NoChunk)
+            Release(chunk);
+        chunk = moved_chunk;
+        return block;
+    }
+
+    CSYS_INLINE void TextArena::Shrink(const char *data, size_t size, size_t unused, uint32_t chunk)
+    {
+        if (m_Chunks.empty() || chunk != Newest())
+            return;
+
+        Chunk &newest = m_Chunks.back();
+        if (data + size == newest.m_Data.get() + newest.m_Used)
+            newest.m_Used -= unused;
+    }
+
+    CSYS_INLINE void TextArena::Release(uint32_t chunk)
+    {
+        Chunk &c = Get(chunk);
+        if (--c.m_Refs)
+            return;
+
+        // Keep newest chunk so it can still be appended to. (Not reused while pinned)
+        if (chunk == Newest())
+        {
+            if (!m_Pins)
+                c.m_Used = 0;
+        }
+        else
+            Free(c);
+    }
+
+    CSYS_INLINE void TextArena::Clear()
+    {
+        if (m_Pins)
+            for (auto &chunk : m_Chunks)
+                if (chunk.m_Data)
+                    m_Pinned.emplace_back(std::move(chunk.m_Data));
+
+        m_First += static_cast<uint32_t>(m_Chunks.size());
+        m_Chunks.clear();
+        m_Spare.reset();
+        m_Capacity = 0;
+    }
+
+    CSYS_INLINE void TextArena::Pin()
+    {
+        ++m_Pins;
+    }
+
+    CSYS_INLINE void TextArena::Unpin()
+    {
+        if (--m_Pins == 0)
+            m_Pinned.clear();
+    }
+
+    CSYS_INLINE size_t TextArena::Capacity() const
+    {
+        return m_Capacity;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Private methods ////////////////////////////////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    CSYS_INLINE char *TextArena::Allocate(size_t size, size_t reserve, uint32_t &chunk)
+    {
+        // New chunk if it doesn't fit.
+        if (m_Chunks.empty() || m_Chunks.back().m_Used + size > m_Chunks.back().m_Size)
+        {
+            Chunk c;
+            c.m_Size = std::max(m_ChunkSize, reserve);
+            if (m_Spare && c.m_Size == m_ChunkSize)
+                c.m_Data = std::move(m_Spare);
+            else
+            {
+                c.m_Data = std::make_unique<char[]>(c.m_Size);
+                m_Capacity += c.m_Size;
+            }
+
+            m_Chunks.emplace_back(std::move(c));
+
+            // Previous newest chunk was only kept alive for appending.
+            if (m_Chunks.size() > 1 && m_Chunks[m_Chunks.size() - 2].m_Refs == 0)
+                Free(m_Chunks[m_Chunks.size() - 2]);
+        }
+
+        Chunk &newest = m_Chunks.back();
+        char *block = newest.m_Data.get() + newest.m_Used;
+        newest.m_Used += size;
+        chunk = Newest();
+        return block;
+    }
+
+    CSYS_INLINE void TextArena::Free(Chunk &chunk)
+    {
+        // Spare chunk memory is still counted.
+        if (!m_Pins && !m_Spare && chunk.m_Size == m_ChunkSize)
+            m_Spare = std::move(chunk.m_Data);
+        else
+        {
+            m_Capacity -= chunk.m_Size;
+            if (m_Pins)
+                m_Pinned.emplace_back(std::move(chunk.m_Data));
+            else
+                chunk.m_Data.reset();
+        }
+
+        // Drop freed chunks from the front.
+        while (m_Chunks.size() > 1 && !m_Chunks.front().m_Data)
+        {
+            m_Chunks.pop_front();
+            ++m_First;
+        }
+    }
+
+    CSYS_INLINE uint32_t TextArena::Newest() const
+    {
+        return m_First + static_cast<uint32_t>(m_Chunks.size()) - 1;
+    }
+
+    CSYS_INLINE TextArena::Chunk &TextArena::Get(uint32_t chunk)
+    {
+        return m_Chunks[chunk - m_First];
+    }
+}
@@ -0,0 +1,95 @@
+// Copyright (c) 2020-present, Roland Munguia & Tristan Florian Bouchard.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#ifndef CSYS_TRIGRAM_INDEX_H
+#define CSYS_TRIGRAM_INDEX_H
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "csys/api.h"
+#include "csys/ring_buffer.h"
+
+namespace csys
+{
+    /*!
+     * \brief
+     *      Inverted index from (ASCII case insensitive) trigrams to the ids of the texts containing them.
+     *      Texts are added in increasing id order and dropped from the front, like items of an ItemLog. Looking up a
+     *      string intersects the posting lists of its trigrams, so its cost depends on how rare the string is, not on
+     *      how much text is indexed.
+     */
+    class CSYS_API TrigramIndex
+    {
+    public:
+
+        /*!
+         * \brief
+         *      Index text
+         * \param id
+         *      Id of the text. Must be greater than every id added before
+         * \param text
+         *      Text to index
+         */
+        void Add(uint64_t id, std::string_view text);
+
+        /*!
+         * \brief
+         *      Forget texts older than an id. (Postings are pruned lazily, in amortized constant time)
+         * \param firstId
+         *      Id of the oldest text still alive
+         */
+        void Drop(uint64_t firstId);
+
+        /*!
+         * \brief
+         *      Remove every text. Ids added afterwards only need to be greater than the ones added so far
+         */
+        void Clear();
+
+        /*!
+         * \brief
+         *      Find texts that may contain a string (Every trigram of the string appears in them). Results must still be
+         *      verified, trigrams don't need to be adjacent or in order
+         * \param str
+         *      String to look up (ASCII case insensitive)
+         * \param ids
+         *      Receives ids of the candidate texts, sorted
+         * \return
+         *      False if the string is too short to be looked up (Less than 3 characters)
+         */
+        bool Find(std::string_view str, std::vector<uint64_t> &ids) const;
+
+        /*!
+         * \return
+         *      Id of the oldest text the index may hold. Texts with older ids were never indexed
+         */
+        [[nodiscard]] uint64_t Base() const;
+
+        /*!
+         * \return
+         *      Approximate memory used by posting lists, in bytes
+         */
+        [[nodiscard]] size_t Bytes() const;
+
+    protected:
+        using Posting = RingBuffer<uint32_t>;    //!< Text ids, relative to m_Base
+
+        static uint32_t Key(std::string_view text, size_t pos);    //!< Case folded trigram at pos
+
+        std::unordered_map<uint32_t, Posting> m_Postings;    //!< Posting list of every trigram seen
+        uint64_t m_Base = 0;                                 //!< Ids are stored relative to this one (32 bits)
+        uint64_t m_First = 0;                                //!< Oldest live id
+        uint64_t m_Pruned = 0;                               //!< Ids below this were removed from all postings
+        uint64_t m_Next = 0;                                 //!< Id following the last one added
+        size_t m_Count = 0;                                  //!< Postings entries
+    };
+}
+
+#ifdef CSYS_HEADER_ONLY
+#include "csys/trigram_index.inl"
+#endif
+
+#endif //CSYS_TRIGRAM_INDEX_H
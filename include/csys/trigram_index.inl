@@ -0,0 +1,150 @@
+// Copyright (c) 2020-present, Roland Munguia & Tristan Florian Bouchard.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#ifndef CSYS_HEADER_ONLY
+
+#include "csys/trigram_index.h"
+
+#endif
+
+#include <algorithm>
+#include <limits>
+
+namespace csys
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Public methods /////////////////////////////////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    CSYS_INLINE void TrigramIndex::Add(uint64_t id, std::string_view text)
+    {
+        // Start over when relative ids would overflow. (Older texts can't be found anymore, see Base())
+        if (id - m_Base > std::numeric_limits<uint32_t>::max())
+        {
+            m_Postings.clear();
+            m_Count = 0;
+            m_Base = m_First = m_Pruned = id;
+        }
+
+        // Ids are increasing, so a trigram seen twice in the same text is already at the back of its posting.
+        auto relative = static_cast<uint32_t>(id - m_Base);
+        for (size_t pos = 0; pos + 3 <= text.size(); ++pos)
+        {
+            Posting &posting = m_Postings[Key(text, pos)];
+            if (posting.empty() || posting.back() != relative)
+            {
+                posting.emplace_back(relative);
+                ++m_Count;
+            }
+        }
+
+        m_Next = id + 1;
+    }
+
+    CSYS_INLINE void TrigramIndex::Drop(uint64_t firstId)
+    {
+        m_First = std::max(m_First, firstId);
+
+        // Prune once there are as many stale ids as live ones.
+        if (m_First - m_Pruned < std::max<uint64_t>(m_Next - m_First, 1024))
+            return;
+
+        auto first = static_cast<uint32_t>(m_First > m_Base ? m_First - m_Base : 0);
+        for (auto it = m_Postings.begin(); it != m_Postings.end();)
+        {
+            Posting &posting = it->second;
+            while (!posting.empty() && posting.front() < first)
+            {
+                posting.pop_front();
+                --m_Count;
+            }
+
+            if (posting.empty())
+                it = m_Postings.erase(it);
+            else
+                ++it;
+        }
+
+        m_Pruned = m_First;
+    }
+
+    CSYS_INLINE void TrigramIndex::Clear()
+    {
+        m_Postings.clear();
+        m_Count = 0;
+        m_Base = m_First = m_Pruned = m_Next;
+    }
+
+    CSYS_INLINE bool TrigramIndex::Find(std::string_view str, std::vector<uint64_t> &ids) const
+    {
+        ids.clear();
+        if (str.size() < 3)
+            return false;
+
+        // Posting lists of the string trigrams. (A trigram never seen means no match)
+        std::vector<const Posting *> lists;
+        for (size_t pos = 0; pos + 3 <= str.size(); ++pos)
+        {
+            auto it = m_Postings.find(Key(str, pos));
+            if (it == m_Postings.end())
+                return true;
+            lists.push_back(&it->second);
+        }
+
+        // Walk the shortest list, looking ids up in the others.
+        std::sort(lists.begin(), lists.end(), [](const Posting *a, const Posting *b)
+        { return a->size() < b->size(); });
+        lists.erase(std::unique(lists.begin(), lists.end()), lists.end());
+
+        auto first = static_cast<uint32_t>(m_First > m_Base ? m_First - m_Base : 0);
+        std::vector<Posting::const_iterator> cursors;
+        for (const Posting *list : lists)
+            cursors.push_back(list->begin());
+
+        const Posting &shortest = *lists.front();
+        for (auto it = std::lower_bound(shortest.begin(), shortest.end(), first); it != shortest.end(); ++it)
+        {
+            bool match = true;
+            for (size_t i = 1; i < lists.size() && match; ++i)
+            {
+                // Cursors only move forward, as ids are sorted.
+                cursors[i] = std::lower_bound(cursors[i], lists[i]->end(), *it);
+                if (cursors[i] == lists[i]->end())
+                    return true;
+                match = *cursors[i] == *it;
+            }
+
+            if (match)
+                ids.push_back(m_Base + *it);
+        }
+
+        return true;
+    }
+
+    CSYS_INLINE uint64_t TrigramIndex::Base() const
+    {
+        return m_Base;
+    }
+
+    CSYS_INLINE size_t TrigramIndex::Bytes() const
+    {
+        return m_Count * sizeof(uint32_t) + m_Postings.size() * (sizeof(uint32_t) + sizeof(Posting) + sizeof(void *) * 2);
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Private methods ////////////////////////////////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    CSYS_INLINE uint32_t TrigramIndex::Key(std::string_view text, size_t pos)
+    {
+        uint32_t key = 0;
+        for (size_t i = pos; i < pos + 3; ++i)
+        {
+            auto c = static_cast<unsigned char>(text[i]);
+            key = key << 8 | (c >= 'A' && c <= 'Z' ? c + ('a' - 'A') : c);
+        }
+        return key;
+    }
+}
@@ -8,6 +8,13 @@
 #include "csys/system.h"
 #include "imgui.h"
 #include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
 
 struct ImGuiSettingsHandler;
 class ImGuiConsole
@@ -21,6 +28,20 @@ public:
      */
     explicit ImGuiConsole(std::string c_name = "imgui-console", size_t inputBufferSize = 256);
 
+    /*!
+     * \brief Construct a view over a shared console system. Views share the log, commands and variables, and only keep
+     *        their own filter, displayed types, scroll state and layout
+     * \param system Console system (See SharedSystem())
+     * \param c_name Name of the console (Unique, it is the window name)
+     * \param inputBufferSize Maximum input buffer size
+     */
+    ImGuiConsole(std::shared_ptr<csys::System> system, std::string c_name, size_t inputBufferSize = 256);
+
+    /*!
+     * \brief Stop filter workers
+     */
+    ~ImGuiConsole();
+
     /*!
      * \brief Render the Dear ImGui Console
      */
@@ -32,11 +53,31 @@ public:
      */
     csys::System &System();
 
+    /*!
+     * \brief Reference counted console system, to open more views over the same log
+     * \return Shared System Obj
+     */
+    std::shared_ptr<csys::System> SharedSystem() const;
+
+    /*!
+     * \brief Set the filter of this view
+     * \param filter Filter, as typed in the filter bar
+     */
+    void SetFilter(std::string_view filter);
+
+    /*!
+     * \brief Show or hide an item type in this view
+     * \param type Item type
+     * \param show Display items of the type
+     */
+    void ShowType(csys::ItemType type, bool show);
+
 protected:
 
     // Console ////////////////////////////////////////////////////////////////
 
-    csys::System m_ConsoleSystem;            //!< Main console system.
+    std::shared_ptr<csys::System> m_SharedSystem;    //!< Owns the console system, with the other views over it.
+    csys::System &m_ConsoleSystem;                   //!< Main console system.
     size_t m_HistoryIndex;                   //!< Command history index.
 
     // Dear ImGui  ////////////////////////////////////////////////////////////
@@ -51,6 +92,87 @@ protected:
     bool m_ScrollToBottom;           //!< Scroll to bottom after is command is ran
     bool m_FilterBar;                //!< Filter bar flag.
     bool m_TimeStamps;                 //!< Display time stamps flag
+    bool m_BatchRendering;             //!< Draw log text straight into the draw list
+    std::array<bool, csys::NONE + 1> m_ShowTypes;    //!< Displayed item types
+    uint64_t m_ErrorJump = ~uint64_t(0);             //!< Id of the error last jumped to
+    bool m_ScrollToError = false;                    //!< Scroll to m_ErrorJump
+    std::vector<uint64_t> m_FilterCandidates;        //!< Ids of items that may pass the filter (Search index results)
+    std::vector<uint64_t> m_TermCandidates;          //!< Search index results of one filter term
+    std::string m_FilterText;                        //!< Filter the cached matches were computed with
+    csys::RingBuffer<uint64_t> m_FilterMatches;      //!< Ids of the items passing the filter
+    uint64_t m_FilterScanned = 0;                    //!< Items with lower ids were checked against the filter
+    uint64_t m_FilterVersion = 0;                    //!< Incremented whenever cached matches are recomputed
+
+    // Background filtering
+
+    struct FilterJob;
+
+    std::shared_ptr<FilterJob> m_FilterJob;                     //!< Job computing matches of the current filter
+    std::vector<std::shared_ptr<FilterJob>> m_FilterRetired;    //!< Cancelled jobs workers may still be reading
+    std::shared_ptr<FilterJob> m_FilterPosted;                  //!< Job handed to workers (Guarded by m_FilterMutex)
+    std::vector<std::thread> m_FilterWorkers;                   //!< Worker threads
+    std::mutex m_FilterMutex;                                   //!< Guards m_FilterPosted and m_FilterStop
+    std::condition_variable m_FilterWake;                       //!< Wakes workers
+    bool m_FilterStop = false;                                  //!< Workers must exit
+
+    // Virtualized log
+
+    struct Row
+    {
+        uint64_t m_Id;        //!< Item id
+        double m_Top;         //!< Top of the row (Prefix sum of wrapped row heights)
+        size_t m_Line;        //!< First wrapped line (Index in m_Lines, plus m_LinesBase)
+        uint32_t m_Lines;     //!< Wrapped line count (Laid out ones only, when folded)
+        float m_Width;        //!< Widest wrapped line
+        bool m_Folded;        //!< Lines past the first ones aren't laid out nor drawn
+        bool m_Foldable;      //!< Too many lines to be displayed whole by default (Followed by a fold marker line)
+        bool m_Collapsed;     //!< Command whose output is hidden (Followed by a group marker line)
+    };
+
+    struct Line
+    {
+        uint32_t m_Begin;     //!< Offset of the first character in item text
+        uint32_t m_End;       //!< Offset past the last character in item text
+    };
+
+    struct Stamp
+    {
+        uint64_t m_Id;        //!< Command item id
+        char m_Text[16];      //!< Formatted time stamp (See csys::Item::FormatTimeStamp)
+    };
+
+    csys::RingBuffer<Row> m_Rows;                      //!< Displayed items
+    csys::RingBuffer<Stamp> m_Stamps;                  //!< Time stamps of displayed commands, formatted once
+    std::vector<csys::ColorSpan> m_DrawSpans;          //!< Color spans of the row being drawn
+    csys::RingBuffer<Line> m_Lines;                    //!< Wrapped lines of every row
+    size_t m_LinesBase = 0;                            //!< Number of lines dropped from the front of m_Lines
+    double m_RowsBottom = 0;                           //!< Bottom of the last row
+    uint64_t m_RowsNext = 0;                           //!< Items with lower ids were laid out, or aren't displayed
+    std::unordered_set<uint64_t> m_Unfolded;           //!< Ids of long items the user unfolded
+    std::unordered_set<uint64_t> m_CollapsedGroups;    //!< Ids of commands whose output the user collapsed
+    uint64_t m_MenuRow = 0;                            //!< Item the row context menu was opened on
+
+    // Selection
+
+    uint64_t m_SelectAnchor = ~uint64_t(0);    //!< Id of the row the selection started at (~0 = Nothing selected)
+    uint64_t m_SelectFocus = ~uint64_t(0);     //!< Id of the row the selection was extended to
+    std::string m_ExportBuffer;                //!< Reusable buffer exported text goes through
+    bool m_RowsFiltered = false;                       //!< Rows were laid out from filter matches
+    uint64_t m_RowsFilterVersion = 0;                  //!< Filter matches rows were laid out from
+    std::array<bool, csys::NONE + 1> m_RowsTypes{};    //!< Types displayed when rows were laid out
+    bool m_RowsTimeStamps = false;                     //!< Time stamps displayed when rows were laid out
+    float m_RowsWidth = -1.f;                          //!< Wrap width rows were laid out with
+    float m_RowsCommandWidth = -1.f;                   //!< Wrap width of commands (Left of time stamps)
+    ImFont *m_RowsFont = nullptr;                      //!< Font rows were laid out with
+    float m_RowsFontSize = 0.f;                        //!< Font size rows were laid out with
+    float m_RowsSpacing = 0.f;                         //!< Item spacing rows were laid out with
+    uint64_t m_RowsVersion = 0;                        //!< Incremented whenever rows are laid out, added or dropped
+
+    // History
+
+    std::string m_HistoryFilter;                //!< Filter history matches were computed with
+    std::vector<uint32_t> m_HistoryMatches;     //!< Spilled lines passing the filter
+    size_t m_HistoryScanned = 0;                //!< Spilled lines tested against the filter
 
     void InitIniSettings();             //!< Initialize Ini Settings handler
     void DefaultSettings();             //!< Restore console default settings
@@ -60,8 +182,38 @@ protected:
     void FilterBar();                 //!< Console filter bar
     void InputBar();                 //!< Console input bar
     void LogWindow();                 //!< Console log
+    void JumpToError(bool next);      //!< Select next/previous error
+    bool NextItem(std::array<size_t, csys::NONE + 1> &cursors, uint64_t end, uint64_t &id); //!< Next displayed item below end, merging type indices
+    bool PassFilter(std::string_view text) const;                                //!< Check text against the filter
+    static bool PassFilter(const ImGuiTextFilter::ImGuiTextRange *begin, const ImGuiTextFilter::ImGuiTextRange *end,
+                           std::string_view text);                               //!< Check text against filter terms
+    void StartFilterJob(bool indexed, uint64_t end);                             //!< Filter candidates or all items in the background
+    void CancelFilterJob();                                                      //!< Drop current filter job
+    void FilterWorker();                                                         //!< Filter worker thread loop
+    bool FilterCandidates();                                                     //!< Look filter terms up in the search index
+    void UpdateFilter();                                                         //!< Check items logged since last frame against the filter
+    bool NextMatch(size_t &match, uint64_t end, uint64_t &id);                   //!< Next displayed filter match below end
+    void UpdateRows();                                                           //!< Lay out items displayed since last frame
+    void AddRow(uint64_t id);                                                    //!< Append item row and its wrapped lines
+    void DrawLines(const Row &row, const csys::Item &item, ImVec2 pos, ImU32 color);    //!< Draw visible wrapped lines of a row
+    void DrawRows(size_t row, double end, double origin);                               //!< Draw visible rows without submitting items
+    const char *FindStamp(uint64_t id) const;                                           //!< Formatted time stamp of a displayed command
+    size_t RowAt(double y) const;                                                        //!< Row at a height of the rows table, or m_Rows.size()
+    void RelayoutFrom(size_t row);                                                      //!< Drop rows from row on, so they are laid out again
+    bool RowInput(ImVec2 base, double origin);                                          //!< Handle row clicks, shortcuts and the row menu, true if rows must be laid out again
+    bool IsSelected(uint64_t id) const;                                                 //!< Is the row of an item selected
+    template<typename Fn>
+    bool ForEachSelected(Fn &&fn);                                                      //!< Call fn with selected items (Every row if none), until it returns false
+    bool ExportText(std::string_view text, std::FILE *file);                            //!< Append a line to m_ExportBuffer, written to file when full (Clipboard if null)
+    bool FlushExport(std::FILE *file);                                                  //!< Write m_ExportBuffer to file and empty it
+    void SetClipboard(bool complete);                                                   //!< Hand m_ExportBuffer to the clipboard, and release it
+    void CopyGroup(uint64_t command);                                                   //!< Copy the output of a command to the clipboard
+    void CopySelection();                                                               //!< Copy selected items to the clipboard
+    void ExportSelection(const std::string &path);                                      //!< Write selected items to a file
+    void HistoryWindow();             //!< Console log evicted to disk
 
     static void HelpMaker(const char *desc);
+    static ImGuiConsole *CommandView(const csys::System &system);    //!< View console commands of a system act on
 
     // Window appearance.
 
@@ -84,6 +236,26 @@ protected:
 
     std::array<ImVec4, COL_COUNT> m_ColorPalette;                //!< Container for all available colors
 
+    // Idle frames
+
+    struct DrawState
+    {
+        uint64_t m_LogVersion = ~uint64_t(0);           //!< ItemLog::Version() (Repeat counts)
+        uint64_t m_RowsVersion = ~uint64_t(0);          //!< Rows drawn from
+        ImVec2 m_Base;                                  //!< Screen position of the first row (Window position and scroll)
+        ImVec4 m_Clip;                                  //!< Clip rect
+        std::array<ImU32, COL_COUNT + 3> m_Colors{};    //!< Palette, text, disabled text and selection colors, with alpha applied
+        bool m_Colored = false;                         //!< Colored output
+        uint64_t m_SelectAnchor = 0;                    //!< Selection
+        uint64_t m_SelectFocus = 0;                     //!< Selection
+
+        bool operator==(const DrawState &rhs) const;
+    };
+
+    DrawState m_DrawState;                  //!< State the cached rows were drawn with
+    ImVector<ImDrawVert> m_DrawVertices;    //!< Vertices of the rows drawn last frame
+    ImVector<ImDrawIdx> m_DrawIndices;      //!< Indices of the rows drawn last frame (Relative to the first vertex)
+
     // ImGui Console Window.
 
     static int InputCallback(ImGuiInputTextCallbackData *data);    //!< Console input callback
@@ -106,6 +278,8 @@ protected:
 
     static void SettingsHandler_WriteAll(ImGuiContext *ctx, ImGuiSettingsHandler *handler, ImGuiTextBuffer *buf);
 
+    void WriteIniSettings(ImGuiSettingsHandler *handler, ImGuiTextBuffer *buf) const;    //!< Write the section of this view
+
     ///////////////////////////////////////////////////////////////////////////
 };
 
@@ -6,6 +6,10 @@
 #include <string>
 #include "imgui_console.h"
 #include "imgui_internal.h"
+#include "csys/string_search.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
 #include <cstring>
 
 // The following three functions (InputTextCallback_UserData, InputTextCallback, InputText) are obtained from misc/cpp/imgui_stdlib.h
@@ -53,11 +57,23 @@ namespace ImGui
     }
 }
 
-ImGuiConsole::ImGuiConsole(std::string c_name, size_t inputBufferSize) : m_ConsoleName(std::move(c_name))
+// Every view, oldest first, and the view running a command typed in its input bar. (UI thread only)
+static std::vector<ImGuiConsole *> s_Views;
+static ImGuiConsole *s_CommandView = nullptr;
+
+ImGuiConsole::ImGuiConsole(std::string c_name, size_t inputBufferSize) : ImGuiConsole(std::make_shared<csys::System>(), std::move(c_name),
+                                                                                      inputBufferSize)
+{
+}
+
+ImGuiConsole::ImGuiConsole(std::shared_ptr<csys::System> system, std::string c_name, size_t inputBufferSize) : m_SharedSystem(std::move(system)),
+                                                                                                               m_ConsoleSystem(*m_SharedSystem),
+                                                                                                               m_ConsoleName(std::move(c_name))
 {
     // Set input buffer size.
     m_Buffer.resize(inputBufferSize);
     m_HistoryIndex = std::numeric_limits<size_t>::min();
+    m_ShowTypes.fill(true);
 
     // Specify custom data to be store/loaded from imgui.ini
     InitIniSettings();
@@ -68,8 +84,10 @@ ImGuiConsole::ImGuiConsole(std::string c_name, size_t inputBufferSize) : m_Conso
         DefaultSettings();
     }
 
-    // Custom functions.
-    RegisterConsoleCommands();
+    // Custom functions. (Once per system, they act on the view running them)
+    if (m_ConsoleSystem.Commands().find("filter") == m_ConsoleSystem.Commands().end())
+        RegisterConsoleCommands();
+    s_Views.push_back(this);
 }
 
 void ImGuiConsole::Draw()
@@ -78,6 +96,9 @@ void ImGuiConsole::Draw()
     // Window and Settings ////////////////////////////////////////////////////
     ///////////////////////////////////////////////////////////////////////////
 
+    // Pull items logged from other threads. (Even when collapsed, so the queue doesn't grow)
+    m_ConsoleSystem.Drain();
+
     // Begin Console Window.
     ImGui::PushStyleVar(ImGuiStyleVar_Alpha, m_WindowAlpha);
     if (!ImGui::Begin(m_ConsoleName.data(), nullptr, ImGuiWindowFlags_MenuBar))
@@ -119,12 +140,41 @@ void ImGuiConsole::Draw()
 csys::System &ImGuiConsole::System()
 { return m_ConsoleSystem; }
 
+std::shared_ptr<csys::System> ImGuiConsole::SharedSystem() const
+{ return m_SharedSystem; }
+
+void ImGuiConsole::SetFilter(std::string_view filter)
+{
+    // Reset filter buffer.
+    std::memset(m_TextFilter.InputBuf, '\0', sizeof(m_TextFilter.InputBuf));
+
+    // Copy filter input buffer from client.
+    std::copy(filter.data(), filter.data() + std::min(filter.size(), sizeof(m_TextFilter.InputBuf) - 1), m_TextFilter.InputBuf);
+
+    // Build text filter.
+    m_TextFilter.Build();
+}
+
+void ImGuiConsole::ShowType(csys::ItemType type, bool show)
+{ m_ShowTypes[type] = show; }
+
+ImGuiConsole *ImGuiConsole::CommandView(const csys::System &system)
+{
+    // Commands run from code act on the oldest view.
+    if (s_CommandView && &s_CommandView->m_ConsoleSystem == &system)
+        return s_CommandView;
+    for (ImGuiConsole *view : s_Views)
+        if (&view->m_ConsoleSystem == &system)
+            return view;
+    return nullptr;
+}
+
 void ImGuiConsole::InitIniSettings()
 {
     ImGuiContext &g = *ImGui::GetCurrentContext();
 
-    // Load from .ini
-    if (g.Initialized && !g.SettingsLoaded && !m_LoadedFromIni)
+    // Load from .ini. (One handler for every view, sections are dispatched by console name)
+    if (g.Initialized && !g.SettingsLoaded && !m_LoadedFromIni && !ImGui::FindSettingsHandler("imgui-console"))
     {
         ImGuiSettingsHandler console_ini_handler;
         console_ini_handler.TypeName = "imgui-console";
@@ -135,7 +185,7 @@ void ImGuiConsole::InitIniSettings()
         console_ini_handler.ReadOpenFn = SettingsHandler_ReadOpen;
         console_ini_handler.ReadLineFn = SettingsHandler_ReadLine;
         console_ini_handler.WriteAllFn = SettingsHandler_WriteAll;
-        console_ini_handler.UserData = this;
+        console_ini_handler.UserData = &s_Views;
         g.SettingsHandlers.push_back(console_ini_handler);
     }
     // else Ini settings already loaded!
@@ -149,6 +199,7 @@ void ImGuiConsole::DefaultSettings()
     m_ColoredOutput = true;
     m_FilterBar = true;
     m_TimeStamps = true;
+    m_BatchRendering = true;
 
     // Style
     m_WindowAlpha = 1;
@@ -162,96 +213,1138 @@ void ImGuiConsole::DefaultSettings()
 
 void ImGuiConsole::RegisterConsoleCommands()
 {
-    m_ConsoleSystem.RegisterCommand("clear", "Clear console log", [this]()
+    // Commands are kept by the system, which may outlive this view.
+    csys::System *system = &m_ConsoleSystem;
+
+    m_ConsoleSystem.RegisterCommand("clear", "Clear console log", [system]()
     {
-        m_ConsoleSystem.Items().clear();
+        system->Logger().Clear();
     });
 
-    m_ConsoleSystem.RegisterCommand("filter", "Set screen filter", [this](const csys::String &filter)
+    m_ConsoleSystem.RegisterCommand("filter", "Set screen filter", [system](const csys::String &filter)
     {
-        // Reset filter buffer.
-        std::memset(m_TextFilter.InputBuf, '\0', 256);
-
-        // Copy filter input buffer from client.
-        std::copy(filter.m_String.c_str(), filter.m_String.c_str() + std::min(static_cast<int>(filter.m_String.length()), 255), m_TextFilter.InputBuf);
-
-        // Build text filter.
-        m_TextFilter.Build();
-
+        if (ImGuiConsole *view = CommandView(*system))
+            view->SetFilter(filter.m_String);
     }, csys::Arg<csys::String>("filter_str"));
 
-    m_ConsoleSystem.RegisterCommand("run", "Run given script", [this](const csys::String &filter)
+    m_ConsoleSystem.RegisterCommand("run", "Run given script", [system](const csys::String &filter)
     {
         // Logs command.
-        m_ConsoleSystem.RunScript(filter.m_String);
+        system->RunScript(filter.m_String);
     }, csys::Arg<csys::String>("script_name"));
+
+    m_ConsoleSystem.RegisterCommand("export", "Export selected items (Or the whole log) to a file", [system](const csys::String &path)
+    {
+        if (ImGuiConsole *view = CommandView(*system))
+            view->ExportSelection(path.m_String);
+    }, csys::Arg<csys::String>("path"));
 }
 
 void ImGuiConsole::FilterBar()
 {
     m_TextFilter.Draw("Filter", ImGui::GetWindowWidth() * 0.25f);
+
+    // Item types, counted through their indices.
+    static const char *type_names[] = {"Commands", "Logs", "Warnings", "Errors", "Info"};
+    csys::ItemLog &log = m_ConsoleSystem.Logger();
+    for (int type = csys::COMMAND; type <= csys::INFO; ++type)
+    {
+        char label[64];
+        std::snprintf(label, sizeof(label), "%s (%zu)###%s", type_names[type], log.TypeIndex(static_cast<csys::ItemType>(type)).size(),
+                      type_names[type]);
+        ImGui::SameLine();
+        ImGui::Checkbox(label, &m_ShowTypes[type]);
+    }
+
+    // Previous/Next error.
+    ImGui::SameLine();
+    if (ImGui::ArrowButton("##PrevError", ImGuiDir_Up)) JumpToError(false);
+    ImGui::SameLine();
+    if (ImGui::ArrowButton("##NextError", ImGuiDir_Down)) JumpToError(true);
+
     ImGui::Separator();
 }
 
-void ImGuiConsole::LogWindow()
+void ImGuiConsole::JumpToError(bool next)
 {
-    const float footerHeightToReserve = ImGui::GetStyle().ItemSpacing.y + ImGui::GetFrameHeightWithSpacing();
-    if (ImGui::BeginChild("ScrollRegion##", ImVec2(0, -footerHeightToReserve), false, 0))
+    const csys::RingBuffer<uint64_t> &errors = m_ConsoleSystem.Logger().TypeIndex(csys::ERROR);
+    if (errors.empty())
+        return;
+
+    // Wrap around at both ends.
+    if (next)
     {
-        // Display colored command output.
-        static const float timestamp_width = ImGui::CalcTextSize("00:00:00:0000").x;    // Timestamp.
-        int count = 0;                                                                       // Item count.
+        auto it = std::upper_bound(errors.begin(), errors.end(), m_ErrorJump);
+        m_ErrorJump = it == errors.end() ? errors.front() : *it;
+    }
+    else
+    {
+        auto it = std::lower_bound(errors.begin(), errors.end(), m_ErrorJump);
+        m_ErrorJump = it == errors.begin() ? errors.back() : *(it - 1);
+    }
+
+    m_ShowTypes[csys::ERROR] = true;
+    m_ScrollToError = true;
+}
+
+// Items to check above which filtering is done in the background.
+static const size_t s_FilterJobItems = 64 * 1024;
+
+// Items checked by a worker at once.
+static const size_t s_FilterJobChunk = 16 * 1024;
+
+/*!
+ * \brief Filter evaluation over a snapshot of the log, shared by the filter workers
+ */
+struct ImGuiConsole::FilterJob
+{
+    std::string m_Filter;                                        //!< Filter text (Terms point into it)
+    std::vector<ImGuiTextFilter::ImGuiTextRange> m_Terms;        //!< Filter terms
+    std::vector<uint64_t> m_Ids;                                 //!< Items to check
+    std::vector<std::string_view> m_Texts;                       //!< Their text (In the pinned log arena, or m_Copies)
+    csys::TextArena m_Copies;                                    //!< Text of formatted deferred items, which isn't pinned
+    std::vector<std::vector<uint64_t>> m_Results;                //!< Matching ids of every chunk
+    uint64_t m_End = 0;                                          //!< Items with lower ids are covered
+    size_t m_Chunks = 0;                                         //!< Number of chunks
+    std::atomic<size_t> m_Next{0};                               //!< Next chunk to be claimed
+    std::atomic<size_t> m_Done{0};                               //!< Chunks completed (Or skipped once cancelled)
+    std::atomic<bool> m_Cancel{false};                           //!< Stale, skip remaining chunks
+
+    [[nodiscard]] bool Finished() const
+    { return m_Done.load(std::memory_order_acquire) == m_Chunks; }
+};
+
+ImGuiConsole::~ImGuiConsole()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_FilterMutex);
+        m_FilterStop = true;
+    }
+    m_FilterWake.notify_all();
+    for (auto &worker : m_FilterWorkers)
+        worker.join();
+
+    // The log may be shared with other views and outlive this one: release pins of unfinished jobs.
+    csys::ItemLog &log = m_ConsoleSystem.Logger();
+    for (size_t job = 0; job < m_FilterRetired.size() + (m_FilterJob ? 1 : 0); ++job)
+        log.Unpin();
+
+    s_Views.erase(std::find(s_Views.begin(), s_Views.end(), this));
+    if (s_CommandView == this)
+        s_CommandView = nullptr;
+}
+
+bool ImGuiConsole::PassFilter(std::string_view text) const
+{
+    return PassFilter(m_TextFilter.Filters.begin(), m_TextFilter.Filters.end(), text);
+}
+
+bool ImGuiConsole::PassFilter(const ImGuiTextFilter::ImGuiTextRange *begin, const ImGuiTextFilter::ImGuiTextRange *end, std::string_view text)
+{
+    // Same rules as ImGuiTextFilter::PassFilter, matching straight on item storage with vectorized search.
+    bool grep = false;
+    for (const ImGuiTextFilter::ImGuiTextRange *term = begin; term != end; ++term)
+    {
+        if (term->empty())
+            continue;
+
+        if (term->b[0] == '-')
+        {
+            if (csys::FindCaseInsensitive(text, std::string_view(term->b + 1, term->e - term->b - 1)) != std::string_view::npos)
+                return false;
+        }
+        else if (csys::FindCaseInsensitive(text, std::string_view(term->b, term->e - term->b)) != std::string_view::npos)
+            return true;
+        else
+            grep = true;
+    }
+
+    // No including term.
+    return !grep;
+}
+
+bool ImGuiConsole::FilterCandidates()
+{
+    // Excluding terms can't be looked up, and with no including term every item passes.
+    if (m_TextFilter.CountGrep == 0)
+        return false;
+
+    // Items matching any including term.
+    csys::ItemLog &log = m_ConsoleSystem.Logger();
+    m_FilterCandidates.clear();
+    for (const ImGuiTextFilter::ImGuiTextRange &term : m_TextFilter.Filters)
+    {
+        if (term.empty() || term.b[0] == '-')
+            continue;
+
+        if (!log.FindCandidates(std::string_view(term.b, term.e - term.b), m_TermCandidates))
+            return false;
+
+        size_t middle = m_FilterCandidates.size();
+        m_FilterCandidates.insert(m_FilterCandidates.end(), m_TermCandidates.begin(), m_TermCandidates.end());
+        std::inplace_merge(m_FilterCandidates.begin(), m_FilterCandidates.begin() + middle, m_FilterCandidates.end());
+    }
+    m_FilterCandidates.erase(std::unique(m_FilterCandidates.begin(), m_FilterCandidates.end()), m_FilterCandidates.end());
+    return true;
+}
+
+void ImGuiConsole::UpdateFilter()
+{
+    csys::ItemLog &log = m_ConsoleSystem.Logger();
+
+    // Cancelled jobs no longer read the log once workers are done with them.
+    for (auto it = m_FilterRetired.begin(); it != m_FilterRetired.end();)
+    {
+        if ((*it)->Finished())
+        {
+            log.Unpin();
+            it = m_FilterRetired.erase(it);
+        }
+        else
+            ++it;
+    }
+
+    if (!m_TextFilter.IsActive())
+    {
+        CancelFilterJob();
+        m_FilterText.clear();
+        m_FilterMatches.clear();
+        return;
+    }
+
+    // New filter, start over. (Only checking search index candidates if possible. The newest item is checked once sealed)
+    const uint64_t end = log.SealedId();
+    if (m_FilterText != m_TextFilter.InputBuf)
+    {
+        m_FilterText = m_TextFilter.InputBuf;
+        CancelFilterJob();
+
+        const bool indexed = FilterCandidates();
+        if ((indexed ? m_FilterCandidates.size() : log.Items().size()) >= s_FilterJobItems)
+            StartFilterJob(indexed, end);
+        else
+        {
+            m_FilterMatches.clear();
+            m_FilterScanned = log.FirstId();
+            ++m_FilterVersion;
+            if (indexed)
+            {
+                for (uint64_t id : m_FilterCandidates)
+                    if (id < end && PassFilter(log.Items()[id - log.FirstId()].View()))
+                        m_FilterMatches.emplace_back(id);
+                m_FilterScanned = end;
+            }
+        }
+    }
+
+    // Publish results all at once.
+    if (m_FilterJob && m_FilterJob->Finished())
+    {
+        m_FilterMatches.clear();
+        for (const auto &result : m_FilterJob->m_Results)
+            for (uint64_t id : result)
+                m_FilterMatches.emplace_back(id);
+        m_FilterScanned = m_FilterJob->m_End;
+        ++m_FilterVersion;
+        {
+            std::lock_guard<std::mutex> lock(m_FilterMutex);
+            if (m_FilterPosted == m_FilterJob)
+                m_FilterPosted.reset();
+        }
+        m_FilterJob.reset();
+        log.Unpin();
+    }
+
+    // Forget evicted items.
+    while (!m_FilterMatches.empty() && m_FilterMatches.front() < log.FirstId())
+        m_FilterMatches.pop_front();
+
+    // Previous results are shown until the job is done.
+    if (m_FilterJob)
+        return;
+    m_FilterScanned = std::max(m_FilterScanned, log.FirstId());
+
+    // Only items logged since last frame are checked.
+    for (; m_FilterScanned < end; ++m_FilterScanned)
+        if (PassFilter(log.Items()[m_FilterScanned - log.FirstId()].View()))
+            m_FilterMatches.emplace_back(m_FilterScanned);
+}
 
-        // Wrap items.
-        ImGui::PushTextWrapPos();
+void ImGuiConsole::StartFilterJob(bool indexed, uint64_t end)
+{
+    csys::ItemLog &log = m_ConsoleSystem.Logger();
+    auto job = std::make_shared<FilterJob>();
+
+    // Filter terms pointing into the job's own copy of the filter.
+    job->m_Filter = m_TextFilter.InputBuf;
+    for (const ImGuiTextFilter::ImGuiTextRange &term : m_TextFilter.Filters)
+        job->m_Terms.emplace_back(job->m_Filter.data() + (term.b - m_TextFilter.InputBuf), job->m_Filter.data() + (term.e - m_TextFilter.InputBuf));
+
+    // Snapshot of the sealed text to check, workers never touch the log itself.
+    size_t count = indexed ? std::lower_bound(m_FilterCandidates.begin(), m_FilterCandidates.end(), end) - m_FilterCandidates.begin()
+                           : end - log.FirstId();
+    job->m_Ids.reserve(count);
+    job->m_Texts.reserve(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        uint64_t id = indexed ? m_FilterCandidates[i] : log.FirstId() + i;
+        const csys::Item &item = log.Items()[id - log.FirstId()];
+        std::string_view text = item.View();
+        if (item.m_Decode)
+        {
+            uint32_t chunk;
+            text = std::string_view(job->m_Copies.Append(text, chunk), text.size());
+        }
+
+        job->m_Ids.push_back(id);
+        job->m_Texts.push_back(text);
+    }
+
+    job->m_End = end;
+    job->m_Chunks = (count + s_FilterJobChunk - 1) / s_FilterJobChunk;
+    job->m_Results.resize(job->m_Chunks);
+
+    // Item text must outlive the job.
+    log.Pin();
+    m_FilterJob = job;
+
+    // Start workers on first use.
+    if (m_FilterWorkers.empty())
+    {
+        unsigned workers = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+        for (unsigned i = 0; i < workers; ++i)
+            m_FilterWorkers.emplace_back(&ImGuiConsole::FilterWorker, this);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_FilterMutex);
+        m_FilterPosted = std::move(job);
+    }
+    m_FilterWake.notify_all();
+}
+
+void ImGuiConsole::CancelFilterJob()
+{
+    if (!m_FilterJob)
+        return;
+
+    // Workers may still be reading it, keep the log pinned until they are done.
+    m_FilterJob->m_Cancel.store(true, std::memory_order_relaxed);
+    m_FilterRetired.emplace_back(std::move(m_FilterJob));
+}
+
+void ImGuiConsole::FilterWorker()
+{
+    std::unique_lock<std::mutex> lock(m_FilterMutex);
+    for (;;)
+    {
+        m_FilterWake.wait(lock, [this]
+        { return m_FilterStop || (m_FilterPosted && m_FilterPosted->m_Next.load(std::memory_order_relaxed) < m_FilterPosted->m_Chunks); });
+        if (m_FilterStop)
+            return;
+
+        std::shared_ptr<FilterJob> job = m_FilterPosted;
+        lock.unlock();
 
-        // Display items.
-        for (const auto &item : m_ConsoleSystem.Items())
+        // Claim chunks until none are left.
+        for (size_t chunk; (chunk = job->m_Next.fetch_add(1, std::memory_order_relaxed)) < job->m_Chunks;)
         {
-            // Exit if word is filtered.
-            if (!m_TextFilter.PassFilter(item.Get().c_str()))
-                continue;
+            size_t begin = chunk * s_FilterJobChunk, end = std::min(begin + s_FilterJobChunk, job->m_Texts.size());
+            std::vector<uint64_t> &result = job->m_Results[chunk];
+            for (size_t i = begin; i < end && !job->m_Cancel.load(std::memory_order_relaxed); ++i)
+                if (PassFilter(job->m_Terms.data(), job->m_Terms.data() + job->m_Terms.size(), job->m_Texts[i]))
+                    result.push_back(job->m_Ids[i]);
 
-            // Spacing between commands.
-            if (item.m_Type == csys::COMMAND)
+            job->m_Done.fetch_add(1, std::memory_order_release);
+        }
+
+        lock.lock();
+    }
+}
+
+bool ImGuiConsole::NextMatch(size_t &match, uint64_t end, uint64_t &id)
+{
+    // Skip hidden types.
+    csys::ItemLog &log = m_ConsoleSystem.Logger();
+    for (; match < m_FilterMatches.size() && m_FilterMatches[match] < end; ++match)
+    {
+        id = m_FilterMatches[match];
+        if (m_ShowTypes[log.Items()[id - log.FirstId()].m_Type])
+        {
+            ++match;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ImGuiConsole::NextItem(std::array<size_t, csys::NONE + 1> &cursors, uint64_t end, uint64_t &id)
+{
+    // Oldest item left among shown types.
+    csys::ItemLog &log = m_ConsoleSystem.Logger();
+    int next = -1;
+    for (int type = csys::COMMAND; type <= csys::NONE; ++type)
+    {
+        const csys::RingBuffer<uint64_t> &index = log.TypeIndex(static_cast<csys::ItemType>(type));
+        if (m_ShowTypes[type] && cursors[type] < index.size() && index[cursors[type]] < end && (next < 0 || index[cursors[type]] < id))
+        {
+            id = index[cursors[type]];
+            next = type;
+        }
+    }
+
+    if (next < 0)
+        return false;
+
+    ++cursors[next];
+    return true;
+}
+
+// Rows wrapping to more lines are folded to the first ones, so a huge item is neither laid out whole nor buries the log.
+static const uint32_t s_FoldLines = 40;
+
+void ImGuiConsole::UpdateRows()
+{
+    csys::ItemLog &log = m_ConsoleSystem.Logger();
+    const bool filtering = m_TextFilter.IsActive();
+    const float width = ImGui::GetContentRegionAvail().x;
+    ImFont *font = ImGui::GetFont();
+    const float fontSize = ImGui::GetFontSize();
+    const float spacing = ImGui::GetStyle().ItemSpacing.y;
+
+    // Lay everything out again when displayed items or their heights changed. (Resize, font, settings, new filter)
+    if (filtering != m_RowsFiltered || (filtering && m_FilterVersion != m_RowsFilterVersion) || m_ShowTypes != m_RowsTypes ||
+        m_TimeStamps != m_RowsTimeStamps || width != m_RowsWidth || font != m_RowsFont || fontSize != m_RowsFontSize ||
+        spacing != m_RowsSpacing)
+    {
+        m_Rows.clear();
+        m_Lines.clear();
+        m_Stamps.clear();
+        m_LinesBase = 0;
+        m_RowsBottom = 0;
+        m_RowsNext = 0;
+        m_RowsFiltered = filtering;
+        m_RowsFilterVersion = m_FilterVersion;
+        m_RowsTypes = m_ShowTypes;
+        m_RowsTimeStamps = m_TimeStamps;
+        m_RowsWidth = width;
+        m_RowsFont = font;
+        m_RowsFontSize = fontSize;
+        m_RowsSpacing = spacing;
+        ++m_RowsVersion;
+
+        // Commands wrap before time stamps start.
+        m_RowsCommandWidth = width;
+        if (m_TimeStamps)
+            m_RowsCommandWidth = ImMax(width - ImGui::CalcTextSize("00:00:00:0000").x - ImGui::GetCursorPosX(), 1.f);
+    }
+
+    // Forget evicted items.
+    while (!m_Rows.empty() && m_Rows.front().m_Id < log.FirstId())
+    {
+        for (uint32_t line = 0; line < m_Rows.front().m_Lines; ++line, ++m_LinesBase)
+            m_Lines.pop_front();
+        m_Rows.pop_front();
+        ++m_RowsVersion;
+    }
+    while (!m_Stamps.empty() && m_Stamps.front().m_Id < log.FirstId())
+        m_Stamps.pop_front();
+    m_RowsNext = std::max(m_RowsNext, log.FirstId());
+
+    // Only items displayed since last frame are measured. (The newest item is left for next frame until sealed, its text may
+    // still change or it may be collapsed)
+    const uint64_t end = log.SealedId();
+    uint64_t id;
+    if (filtering)
+    {
+        size_t match = std::lower_bound(m_FilterMatches.begin(), m_FilterMatches.end(), m_RowsNext) - m_FilterMatches.begin();
+        while (NextMatch(match, end, id))
+        {
+            AddRow(id);
+
+            // Output of collapsed commands is skipped whole.
+            csys::ItemGroup group{};
+            if (m_Rows.back().m_Collapsed && log.FindGroup(id, group))
+                match = std::lower_bound(m_FilterMatches.begin() + match, m_FilterMatches.end(), group.m_End) - m_FilterMatches.begin();
+        }
+        m_RowsNext = std::max(m_RowsNext, std::min(m_FilterScanned, end));
+    }
+    else
+    {
+        std::array<size_t, csys::NONE + 1> cursors{};
+        for (int type = csys::COMMAND; type <= csys::NONE; ++type)
+        {
+            const csys::RingBuffer<uint64_t> &index = log.TypeIndex(static_cast<csys::ItemType>(type));
+            cursors[type] = std::lower_bound(index.begin(), index.end(), m_RowsNext) - index.begin();
+        }
+        while (NextItem(cursors, end, id))
+        {
+            AddRow(id);
+
+            // Output of collapsed commands is skipped whole.
+            csys::ItemGroup group{};
+            if (m_Rows.back().m_Collapsed && log.FindGroup(id, group))
             {
-                if (m_TimeStamps) ImGui::PushTextWrapPos(ImGui::GetColumnWidth() - timestamp_width);    // Wrap before timestamps start.
-                if (count++ != 0) ImGui::Dummy(ImVec2(-1, ImGui::GetFontSize()));                            // No space for the first command.
+                for (int type = csys::COMMAND; type <= csys::NONE; ++type)
+                {
+                    const csys::RingBuffer<uint64_t> &index = log.TypeIndex(static_cast<csys::ItemType>(type));
+                    cursors[type] = std::lower_bound(index.begin() + cursors[type], index.end(), group.m_End) - index.begin();
+                }
             }
+        }
+        m_RowsNext = end;
+    }
+}
+
+void ImGuiConsole::AddRow(uint64_t id)
+{
+    csys::ItemLog &log = m_ConsoleSystem.Logger();
+    const csys::Item &item = log.Items()[id - log.FirstId()];
+    std::string_view text = item.View();
+    const float wrap_width = item.m_Type == csys::COMMAND ? m_RowsCommandWidth : m_RowsWidth;
+    const float scale = m_RowsFontSize / m_RowsFont->FontSize;
+
+    const bool limited = m_Unfolded.find(id) == m_Unfolded.end();
+
+    Row row{id, m_RowsBottom, m_LinesBase + m_Lines.size(), 0, 0.f, false, false, false};
+    const char *begin = text.data(), *end = text.data() + text.size();
+    const char *line = begin, *s = begin, *word_wrap_eol = nullptr;
+    float line_width = 0.f;
+    auto add_line = [&](const char *line_end)
+    {
+        m_Lines.emplace_back(Line{static_cast<uint32_t>(line - begin), static_cast<uint32_t>(line_end - begin)});
+        row.m_Width = ImMax(row.m_Width, line_width);
+        ++row.m_Lines;
+        line_width = 0.f;
+    };
 
-            // Items.
-            if (m_ColoredOutput)
+    // Break lines exactly where ImFont::CalcTextSizeA() and ImFont::RenderText() do, so rendering cached lines
+    // unwrapped looks like wrapped text. Folded rows stop at their last displayed line.
+    while (s < end)
+    {
+        if (!word_wrap_eol)
+        {
+            word_wrap_eol = m_RowsFont->CalcWordWrapPositionA(scale, s, end, wrap_width - line_width);
+            if (word_wrap_eol == s)    // Display at least one character.
+                ++word_wrap_eol;
+        }
+
+        if (s >= word_wrap_eol)
+        {
+            add_line(s);
+            word_wrap_eol = nullptr;
+
+            // Wrapping skips upcoming blanks.
+            while (s < end)
             {
-                ImGui::PushStyleColor(ImGuiCol_Text, m_ColorPalette[item.m_Type]);
-                ImGui::TextUnformatted(item.Get().data());
-                ImGui::PopStyleColor();
+                if (ImCharIsBlankA(*s)) ++s;
+                else if (*s == '\n') { ++s; break; }
+                else break;
             }
-            else
+            line = s;
+            if (limited && row.m_Lines == s_FoldLines && s < end)
             {
-                ImGui::TextUnformatted(item.Get().data());
+                row.m_Folded = true;
+                break;
             }
+            continue;
+        }
 
+        const char *prev_s = s;
+        auto c = static_cast<unsigned int>(static_cast<unsigned char>(*s));
+        if (c < 0x80)
+            ++s;
+        else
+        {
+            s += ImTextCharFromUtf8(&c, s, end);
+            if (c == 0)    // Malformed UTF-8.
+                break;
+        }
 
-            // Time stamp.
-            if (item.m_Type == csys::COMMAND && m_TimeStamps)
+        if (c == '\n')
+        {
+            add_line(prev_s);
+            line = s;
+            if (limited && row.m_Lines == s_FoldLines && s < end)
             {
-                // No wrap for timestamps
-                ImGui::PopTextWrapPos();
+                row.m_Folded = true;
+                break;
+            }
+            continue;
+        }
+        if (c == '\r')
+            continue;
 
-                // Right align.
-                ImGui::SameLine(ImGui::GetColumnWidth(-1) - timestamp_width);
+        line_width += m_RowsFont->GetCharAdvance(static_cast<ImWchar>(c)) * scale;
+    }
+    if (!row.m_Folded && (line_width > 0 || row.m_Lines == 0))
+        add_line(s);
+    row.m_Width = IM_FLOOR(row.m_Width + 0.95f);
+    row.m_Foldable = row.m_Folded || row.m_Lines > s_FoldLines;
+
+    // Commands with collapsed output.
+    csys::ItemGroup group{};
+    row.m_Collapsed = item.m_Type == csys::COMMAND && m_CollapsedGroups.find(id) != m_CollapsedGroups.end() &&
+                      log.FindGroup(id, group) && group.m_End > id + 1;
+
+    // Wrapped text, markers, and spacing before commands. (Left out when the command ends up being the first row)
+    float height = (row.m_Lines + (row.m_Foldable ? 1 : 0) + (row.m_Collapsed ? 1 : 0)) * m_RowsFontSize + m_RowsSpacing;
+    if (item.m_Type == csys::COMMAND)
+        height += m_RowsFontSize + m_RowsSpacing;
+
+    m_Rows.emplace_back(row);
+    m_RowsBottom += height;
+    ++m_RowsVersion;
+
+    // Time stamps are formatted once, drawing them only copies glyphs.
+    if (item.m_Type == csys::COMMAND && m_RowsTimeStamps)
+    {
+        Stamp &stamp = m_Stamps.emplace_back();
+        stamp.m_Id = id;
+        item.FormatTimeStamp(stamp.m_Text);
+    }
+}
 
-                // Draw time stamp.
-                ImGui::PushStyleColor(ImGuiCol_Text, m_ColorPalette[COL_TIMESTAMP]);
-                ImGui::Text("%02d:%02d:%02d:%04d", ((item.m_TimeStamp / 1000 / 3600) % 24), ((item.m_TimeStamp / 1000 / 60) % 60),
-                            ((item.m_TimeStamp / 1000) % 60), item.m_TimeStamp % 1000);
-                ImGui::PopStyleColor();
+const char *ImGuiConsole::FindStamp(uint64_t id) const
+{
+    auto it = std::lower_bound(m_Stamps.begin(), m_Stamps.end(), id, [](const Stamp &stamp, uint64_t id)
+    { return stamp.m_Id < id; });
+    return it != m_Stamps.end() && it->m_Id == id ? it->m_Text : "";
+}
+
+void ImGuiConsole::DrawLines(const Row &row, const csys::Item &item, ImVec2 pos, ImU32 color)
+{
+    // Only lines inside the clip rect are emitted, without measuring or wrapping text again.
+    ImDrawList *drawList = ImGui::GetWindowDrawList();
+    const float clipMin = (drawList->GetClipRectMin().y - pos.y) / m_RowsFontSize;
+    const float clipMax = (drawList->GetClipRectMax().y - pos.y) / m_RowsFontSize;
+    const uint32_t first = clipMin > 0 ? static_cast<uint32_t>(ImMin(clipMin, static_cast<float>(row.m_Lines))) : 0;
+    const uint32_t last = clipMax > 0 ? static_cast<uint32_t>(ImMin(clipMax + 1, static_cast<float>(row.m_Lines))) : 0;
+
+    std::string_view view = item.View();
+    const char *text = view.data();
+
+    // Selection highlight, behind the text.
+    if (IsSelected(row.m_Id))
+    {
+        const float height = (row.m_Lines + (row.m_Foldable ? 1 : 0) + (row.m_Collapsed ? 1 : 0)) * m_RowsFontSize;
+        drawList->AddRectFilled(pos, ImVec2(pos.x + m_RowsWidth, pos.y + height), ImGui::GetColorU32(ImGuiCol_Header));
+    }
 
+    // Fold and group markers, below the lines.
+    char buffer[64];
+    uint32_t marker = row.m_Lines;
+    if (row.m_Foldable && clipMin < marker + 1 && clipMax > marker)
+    {
+        int size = row.m_Folded ? std::snprintf(buffer, sizeof(buffer), "... (%zu more bytes, click to unfold)", view.size() - m_Lines[row.m_Line - m_LinesBase + row.m_Lines - 1].m_End)
+                                : std::snprintf(buffer, sizeof(buffer), "(click to fold)");
+        drawList->AddText(m_RowsFont, m_RowsFontSize, ImVec2(pos.x, pos.y + marker * m_RowsFontSize), ImGui::GetColorU32(ImGuiCol_TextDisabled), buffer, buffer + size);
+    }
+    marker += row.m_Foldable ? 1 : 0;
+    csys::ItemGroup group{};
+    if (row.m_Collapsed && clipMin < marker + 1 && clipMax > marker && m_ConsoleSystem.Logger().FindGroup(row.m_Id, group))
+    {
+        int size = std::snprintf(buffer, sizeof(buffer), "... (%llu output items, click to expand)", static_cast<unsigned long long>(group.m_End - group.m_Command - 1));
+        drawList->AddText(m_RowsFont, m_RowsFontSize, ImVec2(pos.x, pos.y + marker * m_RowsFontSize), ImGui::GetColorU32(ImGuiCol_TextDisabled), buffer, buffer + size);
+    }
+
+    if (!m_ColoredOutput || !item.m_Spans)
+    {
+        for (uint32_t i = first; i < last; ++i)
+        {
+            const Line &line = m_Lines[row.m_Line - m_LinesBase + i];
+            drawList->AddText(m_RowsFont, m_RowsFontSize, ImVec2(pos.x, pos.y + i * m_RowsFontSize), color, text + line.m_Begin, text + line.m_End);
+        }
+        return;
+    }
+
+    // Color spans were parsed when the item was logged, lines are only split into runs where colors change.
+    m_DrawSpans.resize(item.m_Spans);
+    for (size_t span = 0; span < m_DrawSpans.size(); ++span)
+        m_DrawSpans[span] = item.Span(span);
+
+    size_t span = 0;
+    for (uint32_t i = first; i < last; ++i)
+    {
+        const Line &line = m_Lines[row.m_Line - m_LinesBase + i];
+        float x = pos.x;
+        for (uint32_t begin = line.m_Begin; begin < line.m_End;)
+        {
+            while (span < m_DrawSpans.size() && m_DrawSpans[span].m_Offset <= begin)
+                ++span;
+
+            uint32_t end = span < m_DrawSpans.size() ? ImMin(m_DrawSpans[span].m_Offset, line.m_End) : line.m_End;
+            uint32_t runColor = span > 0 ? m_DrawSpans[span - 1].m_Color : 0;
+            drawList->AddText(m_RowsFont, m_RowsFontSize, ImVec2(x, pos.y + i * m_RowsFontSize), runColor ? ImGui::GetColorU32(runColor) : color,
+                              text + begin, text + end);
+            if (end < line.m_End)
+                x += m_RowsFont->CalcTextSizeA(m_RowsFontSize, FLT_MAX, 0.f, text + begin, text + end).x;
+            begin = end;
+        }
+    }
+}
+
+size_t ImGuiConsole::RowAt(double y) const
+{
+    size_t row = std::upper_bound(m_Rows.begin(), m_Rows.end(), y, [](double y, const Row &r)
+    { return y < r.m_Top; }) - m_Rows.begin();
+    return row > 0 && y < m_RowsBottom ? row - 1 : m_Rows.size();
+}
+
+void ImGuiConsole::RelayoutFrom(size_t row)
+{
+    if (row >= m_Rows.size())
+        return;
+
+    // Rows above keep their place.
+    const uint64_t id = m_Rows[row].m_Id;
+    m_RowsBottom = m_Rows[row].m_Top;
+    m_RowsNext = id;
+    while (m_Rows.size() > row)
+    {
+        for (uint32_t line = 0; line < m_Rows.back().m_Lines; ++line)
+            m_Lines.pop_back();
+        m_Rows.pop_back();
+    }
+    while (!m_Stamps.empty() && m_Stamps.back().m_Id >= id)
+        m_Stamps.pop_back();
+    ++m_RowsVersion;
+}
+
+bool ImGuiConsole::RowInput(ImVec2 base, double origin)
+{
+    csys::ItemLog &log = m_ConsoleSystem.Logger();
+    const ImGuiIO &io = ImGui::GetIO();
+    bool relayout = false;
+
+    // Row under the mouse.
+    const bool hovered = ImGui::IsWindowHovered();
+    const double y = io.MousePos.y - base.y + origin;
+    const size_t row = hovered ? RowAt(y) : m_Rows.size();
+    if (row < m_Rows.size())
+    {
+        const Row &r = m_Rows[row];
+        const bool command = log.Items()[r.m_Id - log.FirstId()].m_Type == csys::COMMAND;
+
+        // Markers follow the wrapped lines: fold marker first, then group marker.
+        const double text = r.m_Top + (command ? m_RowsFontSize + m_RowsSpacing : 0);
+        const int marker = static_cast<int>(std::floor((y - text) / m_RowsFontSize)) - static_cast<int>(r.m_Lines);
+        const bool fold = r.m_Foldable && marker == 0;
+        const bool group = r.m_Collapsed && marker == (r.m_Foldable ? 1 : 0);
+        if (fold || group)
+        {
+            ImGui::SetMouseCursor(ImGuiMouseCursor_Hand);
+            if (ImGui::IsMouseClicked(ImGuiMouseButton_Left))
+            {
+                if (fold && r.m_Folded)
+                    m_Unfolded.insert(r.m_Id);
+                else if (fold)
+                    m_Unfolded.erase(r.m_Id);
+                else
+                    m_CollapsedGroups.erase(r.m_Id);
+                RelayoutFrom(row);
+                relayout = true;
             }
         }
 
-        // Stop wrapping since we are done displaying console items.
-        ImGui::PopTextWrapPos();
+        // Selection. (Shift extends it)
+        else if (ImGui::IsMouseClicked(ImGuiMouseButton_Left))
+        {
+            if (!io.KeyShift || m_SelectAnchor == ~uint64_t(0))
+                m_SelectAnchor = r.m_Id;
+            m_SelectFocus = r.m_Id;
+        }
+
+        // Row menu, on the selection or on the clicked row.
+        else if (ImGui::IsMouseClicked(ImGuiMouseButton_Right))
+        {
+            if (!IsSelected(r.m_Id))
+                m_SelectAnchor = m_SelectFocus = r.m_Id;
+            m_MenuRow = r.m_Id;
+            ImGui::OpenPopup("RowMenu##");
+        }
+    }
+    else if (hovered && ImGui::IsMouseClicked(ImGuiMouseButton_Left))
+        m_SelectAnchor = m_SelectFocus = ~uint64_t(0);
+
+    // Shortcuts.
+    if (ImGui::IsWindowFocused() && io.KeyCtrl)
+    {
+        if (ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_A)) && !m_Rows.empty())
+        {
+            m_SelectAnchor = m_Rows.front().m_Id;
+            m_SelectFocus = m_Rows.back().m_Id;
+        }
+        if (ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_C)) && m_SelectAnchor != ~uint64_t(0))
+            CopySelection();
+    }
+
+    if (ImGui::BeginPopup("RowMenu##"))
+    {
+        // Commands with output.
+        csys::ItemGroup group{};
+        if (log.FindGroup(m_MenuRow, group) && group.m_End > group.m_Command + 1)
+        {
+            const bool collapsed = m_CollapsedGroups.find(m_MenuRow) != m_CollapsedGroups.end();
+            if (ImGui::MenuItem(collapsed ? "Expand output" : "Collapse output"))
+            {
+                if (collapsed)
+                    m_CollapsedGroups.erase(m_MenuRow);
+                else
+                    m_CollapsedGroups.insert(m_MenuRow);
+                RelayoutFrom(std::lower_bound(m_Rows.begin(), m_Rows.end(), m_MenuRow, [](const Row &r, uint64_t id)
+                                              { return r.m_Id < id; }) - m_Rows.begin());
+                relayout = true;
+            }
+            if (ImGui::MenuItem("Copy output"))
+                CopyGroup(m_MenuRow);
+            ImGui::Separator();
+        }
+
+        if (ImGui::MenuItem("Copy selection", "Ctrl+C", false, m_SelectAnchor != ~uint64_t(0)))
+            CopySelection();
+        if (ImGui::MenuItem("Select all", "Ctrl+A", false, !m_Rows.empty()))
+        {
+            m_SelectAnchor = m_Rows.front().m_Id;
+            m_SelectFocus = m_Rows.back().m_Id;
+        }
+        if (ImGui::MenuItem("Clear selection", nullptr, false, m_SelectAnchor != ~uint64_t(0)))
+            m_SelectAnchor = m_SelectFocus = ~uint64_t(0);
+        ImGui::EndPopup();
+    }
+
+    // Forget evicted items.
+    if (relayout)
+    {
+        for (auto *ids : {&m_Unfolded, &m_CollapsedGroups})
+            for (auto it = ids->begin(); it != ids->end();)
+                it = *it < log.FirstId() ? ids->erase(it) : std::next(it);
+    }
+    return relayout;
+}
+
+bool ImGuiConsole::IsSelected(uint64_t id) const
+{
+    return m_SelectAnchor != ~uint64_t(0) && id >= std::min(m_SelectAnchor, m_SelectFocus) && id <= std::max(m_SelectAnchor, m_SelectFocus);
+}
+
+template<typename Fn>
+bool ImGuiConsole::ForEachSelected(Fn &&fn)
+{
+    csys::ItemLog &log = m_ConsoleSystem.Logger();
+    size_t first = 0, last = m_Rows.size();
+    if (m_SelectAnchor != ~uint64_t(0))
+    {
+        auto byId = [](const Row &r, uint64_t id)
+        { return r.m_Id < id; };
+        first = std::lower_bound(m_Rows.begin(), m_Rows.end(), std::min(m_SelectAnchor, m_SelectFocus), byId) - m_Rows.begin();
+        last = std::lower_bound(m_Rows.begin(), m_Rows.end(), std::max(m_SelectAnchor, m_SelectFocus) + 1, byId) - m_Rows.begin();
+    }
+
+    // Displayed rows, and the hidden output of collapsed commands. (Rows may be stale when run from a command, after
+    // items were cleared or evicted)
+    const uint64_t end = log.FirstId() + log.Items().size();
+    for (size_t row = first; row < last; ++row)
+    {
+        const uint64_t id = m_Rows[row].m_Id;
+        if (id < log.FirstId())
+            continue;
+        if (id >= end)
+            break;
+        if (!fn(log.Items()[id - log.FirstId()]))
+            return false;
+
+        csys::ItemGroup group{};
+        if (m_Rows[row].m_Collapsed && log.FindGroup(id, group))
+            for (uint64_t output = id + 1; output < group.m_End; ++output)
+                if (!fn(log.Items()[output - log.FirstId()]))
+                    return false;
+    }
+    return true;
+}
+
+// Exported text is written to files in chunks of this size, whatever the amount selected.
+static const size_t s_ExportChunk = 256 * 1024;
+
+// Clipboard text has to be a single string, so it is capped.
+static const size_t s_ClipboardLimit = 64 * 1024 * 1024;
+
+bool ImGuiConsole::ExportText(std::string_view text, std::FILE *file)
+{
+    // One item per line.
+    const bool newline = text.empty() || text.back() != '\n';
+    const size_t size = text.size() + (newline ? 1 : 0);
+    if (!file && m_ExportBuffer.size() + size > s_ClipboardLimit)
+        return false;
+    if (file && m_ExportBuffer.size() + size > s_ExportChunk)
+    {
+        if (!FlushExport(file))
+            return false;
+
+        // Items larger than a chunk are written straight from the log.
+        if (size > s_ExportChunk)
+            return std::fwrite(text.data(), 1, text.size(), file) == text.size() && (!newline || std::fputc('\n', file) != EOF);
+    }
+
+    m_ExportBuffer.append(text.data(), text.size());
+    if (newline)
+        m_ExportBuffer += '\n';
+    return true;
+}
+
+bool ImGuiConsole::FlushExport(std::FILE *file)
+{
+    const bool written = std::fwrite(m_ExportBuffer.data(), 1, m_ExportBuffer.size(), file) == m_ExportBuffer.size();
+    m_ExportBuffer.clear();
+    return written;
+}
+
+void ImGuiConsole::SetClipboard(bool complete)
+{
+    if (complete)
+        ImGui::SetClipboardText(m_ExportBuffer.c_str());
+    else
+        m_ConsoleSystem.Log(csys::WARNING) << "Too much text for the clipboard, use the export command instead" << csys::endl;
+
+    // Only a chunk sized buffer is kept around.
+    if (m_ExportBuffer.capacity() > s_ExportChunk)
+        std::string().swap(m_ExportBuffer);
+    m_ExportBuffer.clear();
+}
+
+void ImGuiConsole::CopyGroup(uint64_t command)
+{
+    csys::ItemLog &log = m_ConsoleSystem.Logger();
+    csys::ItemGroup group{};
+    if (!log.FindGroup(command, group))
+        return;
+
+    // Output is the item range following the command.
+    bool complete = true;
+    m_ExportBuffer.clear();
+    for (uint64_t id = group.m_Command + 1; id < group.m_End && complete; ++id)
+        complete = ExportText(log.Items()[id - log.FirstId()].View(), nullptr);
+    SetClipboard(complete);
+}
+
+void ImGuiConsole::CopySelection()
+{
+    m_ExportBuffer.clear();
+    SetClipboard(ForEachSelected([this](const csys::Item &item)
+                                 { return ExportText(item.View(), nullptr); }));
+}
+
+void ImGuiConsole::ExportSelection(const std::string &path)
+{
+    std::FILE *file = std::fopen(path.c_str(), "wb");
+    if (!file)
+    {
+        m_ConsoleSystem.Log(csys::ERROR) << "Could not open \"" << path << "\"" << csys::endl;
+        return;
+    }
+
+    // Text is streamed from item storage through the export buffer, one chunk at a time.
+    size_t items = 0;
+    m_ExportBuffer.clear();
+    m_ExportBuffer.reserve(s_ExportChunk);
+    bool written = ForEachSelected([&](const csys::Item &item)
+                                   {
+                                       ++items;
+                                       return ExportText(item.View(), file);
+                                   }) && FlushExport(file);
+    written = std::fclose(file) == 0 && written;
+    m_ExportBuffer.clear();
+
+    if (written)
+        m_ConsoleSystem.Log(csys::INFO) << "Exported " << items << " items to \"" << path << "\"" << csys::endl;
+    else
+        m_ConsoleSystem.Log(csys::ERROR) << "Could not write \"" << path << "\"" << csys::endl;
+}
+
+bool ImGuiConsole::DrawState::operator==(const DrawState &rhs) const
+{
+    return m_LogVersion == rhs.m_LogVersion && m_RowsVersion == rhs.m_RowsVersion && m_Base.x == rhs.m_Base.x &&
+           m_Base.y == rhs.m_Base.y && m_Clip.x == rhs.m_Clip.x && m_Clip.y == rhs.m_Clip.y && m_Clip.z == rhs.m_Clip.z &&
+           m_Clip.w == rhs.m_Clip.w && m_Colors == rhs.m_Colors && m_Colored == rhs.m_Colored &&
+           m_SelectAnchor == rhs.m_SelectAnchor && m_SelectFocus == rhs.m_SelectFocus;
+}
+
+void ImGuiConsole::DrawRows(size_t row, double end, double origin)
+{
+    ImDrawList *drawList = ImGui::GetWindowDrawList();
+    DrawState state;
+    state.m_LogVersion = m_ConsoleSystem.Logger().Version();
+    state.m_RowsVersion = m_RowsVersion;
+    state.m_Base = ImGui::GetCursorScreenPos();
+    state.m_Clip = drawList->_ClipRectStack.back();
+    for (int color = 0; color < COL_COUNT; ++color)
+        state.m_Colors[color] = ImGui::GetColorU32(m_ColorPalette[color]);
+    state.m_Colors[COL_COUNT] = ImGui::GetColorU32(ImGuiCol_Text);
+    state.m_Colors[COL_COUNT + 1] = ImGui::GetColorU32(ImGuiCol_TextDisabled);
+    state.m_Colors[COL_COUNT + 2] = ImGui::GetColorU32(ImGuiCol_Header);
+    state.m_Colored = m_ColoredOutput;
+    state.m_SelectAnchor = m_SelectAnchor;
+    state.m_SelectFocus = m_SelectFocus;
+
+    // Nothing changed since last frame (No new items, scroll, resize, filter or settings change): replay its vertices.
+    if (state == m_DrawState)
+    {
+        drawList->PrimReserve(m_DrawIndices.Size, m_DrawVertices.Size);
+        std::memcpy(drawList->_VtxWritePtr, m_DrawVertices.Data, m_DrawVertices.size_in_bytes());
+        for (int i = 0; i < m_DrawIndices.Size; ++i)
+            drawList->_IdxWritePtr[i] = static_cast<ImDrawIdx>(drawList->_VtxCurrentIdx + m_DrawIndices[i]);
+        drawList->_VtxWritePtr += m_DrawVertices.Size;
+        drawList->_IdxWritePtr += m_DrawIndices.Size;
+        drawList->_VtxCurrentIdx += m_DrawVertices.Size;
+        return;
+    }
+
+    const int commands = drawList->CmdBuffer.Size;
+    const int firstVertex = drawList->VtxBuffer.Size;
+    const int firstIndex = drawList->IdxBuffer.Size;
+    const unsigned int vertexBase = drawList->_VtxCurrentIdx;
+
+    // Rows are placed from the prefix table instead of the layout cursor, so no item is submitted to ImGui.
+    csys::ItemLog &log = m_ConsoleSystem.Logger();
+    const ImVec2 base = state.m_Base;
+    const ImGuiStyle &style = ImGui::GetStyle();
+    const float gap = m_RowsFontSize + style.ItemSpacing.y;
+    const float timestampX = ImGui::GetWindowPos().x + m_RowsWidth - ImGui::CalcTextSize("00:00:00:0000").x;
+    const ImU32 textColor = state.m_Colors[COL_COUNT];
+    const ImU32 disabledColor = state.m_Colors[COL_COUNT + 1];
+    const ImU32 timestampColor = state.m_Colors[COL_TIMESTAMP];
+
+    // Colors are vertex attributes, so every run ends up in the same draw command whatever its color.
+    char buffer[32];
+    for (; row < m_Rows.size() && m_Rows[row].m_Top < end; ++row)
+    {
+        const Row &r = m_Rows[row];
+        const csys::Item &item = log.Items()[r.m_Id - log.FirstId()];
+
+        // Spacing between commands. (The first row's is left out of origin)
+        const ImVec2 pos(base.x, base.y + static_cast<float>(r.m_Top - origin) + (item.m_Type == csys::COMMAND ? gap : 0.f));
+        DrawLines(r, item, pos, m_ColoredOutput ? state.m_Colors[item.m_Type] : textColor);
+
+        // Collapsed repeats.
+        if (item.m_Repeat > 1)
+        {
+            int size = std::snprintf(buffer, sizeof(buffer), "(x%u)", item.m_Repeat);
+            drawList->AddText(m_RowsFont, m_RowsFontSize, ImVec2(pos.x + r.m_Width + style.ItemSpacing.x, pos.y), disabledColor, buffer, buffer + size);
+        }
+
+        // Time stamp, right aligned.
+        if (item.m_Type == csys::COMMAND && m_TimeStamps)
+        {
+            const char *stamp = FindStamp(r.m_Id);
+            drawList->AddText(m_RowsFont, m_RowsFontSize, ImVec2(timestampX, pos.y), timestampColor, stamp, stamp + std::strlen(stamp));
+        }
+    }
+
+    // Keep vertices for next frame. (Unless the draw list had to start a new draw command in between)
+    m_DrawState = DrawState();
+    if (drawList->CmdBuffer.Size != commands)
+        return;
+    m_DrawVertices.resize(drawList->VtxBuffer.Size - firstVertex);
+    std::memcpy(m_DrawVertices.Data, drawList->VtxBuffer.Data + firstVertex, m_DrawVertices.size_in_bytes());
+    m_DrawIndices.resize(drawList->IdxBuffer.Size - firstIndex);
+    for (int i = 0; i < m_DrawIndices.Size; ++i)
+        m_DrawIndices[i] = static_cast<ImDrawIdx>(drawList->IdxBuffer[firstIndex + i] - vertexBase);
+    m_DrawState = state;
+}
+
+void ImGuiConsole::LogWindow()
+{
+    const float footerHeightToReserve = ImGui::GetStyle().ItemSpacing.y + ImGui::GetFrameHeightWithSpacing();
+    if (ImGui::BeginChild("ScrollRegion##", ImVec2(0, -footerHeightToReserve), false, 0))
+    {
+        // Display colored command output.
+        static const float timestamp_width = ImGui::CalcTextSize("00:00:00:0000").x;    // Timestamp.
+
+        // Items evicted to disk.
+        HistoryWindow();
+
+        // Display items. Hidden types are skipped through the per type indices, their items are never visited.
+        // When filtering, cached matches are walked instead.
+        csys::ItemLog &log = m_ConsoleSystem.Logger();
+        UpdateFilter();
+        if (m_FilterJob)
+            ImGui::TextDisabled("Filtering... %d%%", static_cast<int>(100 * m_FilterJob->m_Done.load(std::memory_order_relaxed) / m_FilterJob->m_Chunks));
+        UpdateRows();
+
+        // Rows are positioned from their wrapped heights, so only the visible ones are submitted.
+        const float top = ImGui::GetCursorPosY();
+        const float spacing = ImGui::GetStyle().ItemSpacing.y;
+        const double origin = m_Rows.empty() ? 0 : m_Rows.front().m_Top + (log.Items()[m_Rows.front().m_Id - log.FirstId()].m_Type == csys::COMMAND ? m_RowsFontSize + spacing : 0);
+
+        // Long items folded, command output expanded or collapsed. (Keeps origin, the first row stays in place)
+        if (RowInput(ImGui::GetCursorScreenPos(), origin))
+            UpdateRows();
+        const double visible = ImGui::GetScrollY() - top + origin;
+        size_t row = std::upper_bound(m_Rows.begin(), m_Rows.end(), visible, [](double y, const Row &r)
+        { return y < r.m_Top; }) - m_Rows.begin();
+        row = row > 0 ? row - 1 : 0;
+
+        // Error selected through the filter bar.
+        if (m_ScrollToError)
+        {
+            size_t error = std::lower_bound(m_Rows.begin(), m_Rows.end(), m_ErrorJump, [](const Row &r, uint64_t id)
+            { return r.m_Id < id; }) - m_Rows.begin();
+            if (error < m_Rows.size() && m_Rows[error].m_Id == m_ErrorJump)
+            {
+                double bottom = error + 1 < m_Rows.size() ? m_Rows[error + 1].m_Top : m_RowsBottom;
+                ImGui::SetScrollFromPosY(top + static_cast<float>(bottom - origin) - spacing - ImGui::GetScrollY(), 0.5f);
+                m_ScrollToError = false;
+            }
+        }
+
+        const double end = visible + ImGui::GetWindowHeight();
+        if (m_BatchRendering)
+            DrawRows(row, end, origin);
+        else
+        {
+            if (row > 0 && row < m_Rows.size())
+                ImGui::SetCursorPosY(top + static_cast<float>(m_Rows[row].m_Top - origin));
+            for (; row < m_Rows.size() && m_Rows[row].m_Top < end; ++row)
+            {
+                const csys::Item &item = log.Items()[m_Rows[row].m_Id - log.FirstId()];
+
+                // Spacing between commands.
+                if (item.m_Type == csys::COMMAND && row != 0)
+                    ImGui::Dummy(ImVec2(-1, ImGui::GetFontSize()));    // No space for the first command.
+
+                // Items, wrapped when laid out. (Commands wrap before timestamps start)
+                DrawLines(m_Rows[row], item, ImGui::GetCursorScreenPos(), ImGui::GetColorU32(m_ColoredOutput ? m_ColorPalette[item.m_Type] : ImGui::GetStyleColorVec4(ImGuiCol_Text)));
+                const Row &r = m_Rows[row];
+                ImGui::Dummy(ImVec2(r.m_Width, (r.m_Lines + (r.m_Foldable ? 1 : 0) + (r.m_Collapsed ? 1 : 0)) * m_RowsFontSize));
+
+                // Collapsed repeats.
+                if (item.m_Repeat > 1)
+                {
+                    ImGui::SameLine();
+                    ImGui::TextDisabled("(x%u)", item.m_Repeat);
+                }
+
+                // Time stamp.
+                if (item.m_Type == csys::COMMAND && m_TimeStamps)
+                {
+                    // Right align.
+                    ImGui::SameLine(ImGui::GetColumnWidth(-1) - timestamp_width);
+
+                    // Draw time stamp.
+                    ImGui::PushStyleColor(ImGuiCol_Text, m_ColorPalette[COL_TIMESTAMP]);
+                    ImGui::TextUnformatted(FindStamp(m_Rows[row].m_Id));
+                    ImGui::PopStyleColor();
+
+                }
+            }
+        }
+
+        // Extend the scroll region to the bottom of the last row.
+        if (!m_Rows.empty())
+        {
+            ImGui::SetCursorPosY(top + static_cast<float>(m_RowsBottom - origin) - spacing);
+            ImGui::Dummy(ImVec2(0, 0));
+        }
 
         // Auto-scroll logs.
         if ((m_ScrollToBottom && (ImGui::GetScrollY() >= ImGui::GetScrollMaxY() || m_AutoScroll)))
@@ -263,6 +1356,57 @@ void ImGuiConsole::LogWindow()
     }
 }
 
+// Spilled lines checked against the filter per frame, so filtering a huge history doesn't stall the UI.
+static const size_t s_HistoryScanLines = 32 * 1024;
+
+void ImGuiConsole::HistoryWindow()
+{
+    csys::SpillFile &spilled = m_ConsoleSystem.Logger().Spilled();
+    if (spilled.Size() == 0 || !ImGui::CollapsingHeader("History"))
+        return;
+
+    if (spilled.Failed())
+        ImGui::TextDisabled("Writing history failed, newer lines are dropped.");
+
+    // Lines matching filter, extended as more lines are spilled. (A few at a time, the file is remapped at most once per frame)
+    if (m_TextFilter.IsActive())
+    {
+        if (m_HistoryFilter != m_TextFilter.InputBuf || m_HistoryScanned > spilled.Size())
+        {
+            m_HistoryFilter = m_TextFilter.InputBuf;
+            m_HistoryMatches.clear();
+            m_HistoryScanned = 0;
+        }
+
+        const size_t end = std::min(spilled.Size(), m_HistoryScanned + s_HistoryScanLines);
+        for (; m_HistoryScanned < end; ++m_HistoryScanned)
+        {
+            std::string_view text = spilled.Get(m_HistoryScanned).m_Text;
+            if (PassFilter(text))
+                m_HistoryMatches.push_back(static_cast<uint32_t>(m_HistoryScanned));
+        }
+
+        if (m_HistoryScanned < spilled.Size())
+            ImGui::TextDisabled("Filtering history... (%zu/%zu lines)", m_HistoryScanned, spilled.Size());
+    }
+
+    // Lines aren't wrapped, so only visible ones are read from disk.
+    const bool filtered = m_TextFilter.IsActive();
+    ImGuiListClipper clipper(static_cast<int>(filtered ? m_HistoryMatches.size() : spilled.Size()), ImGui::GetTextLineHeightWithSpacing());
+    while (clipper.Step())
+    {
+        for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; ++i)
+        {
+            csys::SpillFile::Line line = spilled.Get(filtered ? m_HistoryMatches[i] : static_cast<size_t>(i));
+            if (m_ColoredOutput) ImGui::PushStyleColor(ImGuiCol_Text, m_ColorPalette[line.m_Type]);
+            ImGui::TextUnformatted(line.m_Text.data(), line.m_Text.data() + line.m_Text.size());
+            if (m_ColoredOutput) ImGui::PopStyleColor();
+        }
+    }
+
+    ImGui::Separator();
+}
+
 void ImGuiConsole::InputBar()
 {
     // Variables.
@@ -280,8 +1424,10 @@ void ImGuiConsole::InputBar()
         // Validate.
         if (!m_Buffer.empty())
         {
-            // Run command line input.
+            // Run command line input. (Console commands act on this view)
+            s_CommandView = this;
             m_ConsoleSystem.RunCommand(m_Buffer);
+            s_CommandView = nullptr;
 
             // Scroll to bottom after its ran.
             m_ScrollToBottom = true;
@@ -335,6 +1481,11 @@ void ImGuiConsole::MenuBar()
             ImGui::SameLine();
             HelpMaker("Display command execution timestamps");
 
+            // Batch rendering
+            ImGui::Checkbox("Batch Rendering", &m_BatchRendering);
+            ImGui::SameLine();
+            HelpMaker("Draw log text straight into the window draw list instead of submitting items");
+
             // Reset to default settings
             if (ImGui::Button("Reset settings", ImVec2(ImGui::GetColumnWidth(), 0)))
                 ImGui::OpenPopup("Reset Settings?");
@@ -562,20 +1713,20 @@ void *ImGuiConsole::SettingsHandler_ReadOpen(ImGuiContext *ctx, ImGuiSettingsHan
     if (!handler->UserData)
         return nullptr;
 
-    auto console = static_cast<ImGuiConsole *>(handler->UserData);
-
-    if (strcmp(name, console->m_ConsoleName.c_str()) != 0)
-        return nullptr;
-    return (void *) 1;
+    // Entry is the view of the section.
+    for (ImGuiConsole *console : *static_cast<std::vector<ImGuiConsole *> *>(handler->UserData))
+        if (strcmp(name, console->m_ConsoleName.c_str()) == 0)
+            return console;
+    return nullptr;
 }
 
 void ImGuiConsole::SettingsHandler_ReadLine(ImGuiContext *ctx, ImGuiSettingsHandler *handler, void *entry, const char *line)
 {
-    if (!handler->UserData)
+    if (!entry)
         return;
 
     // Get console.
-    auto console = static_cast<ImGuiConsole *>(handler->UserData);
+    auto console = static_cast<ImGuiConsole *>(entry);
 
     // Ensure console doesn't reset variables.
     console->m_LoadedFromIni = true;
@@ -606,6 +1757,7 @@ void ImGuiConsole::SettingsHandler_ReadLine(ImGuiContext *ctx, ImGuiSettingsHand
     else if INI_CONSOLE_LOAD_BOOL(m_ColoredOutput)
     else if INI_CONSOLE_LOAD_BOOL(m_FilterBar)
     else if INI_CONSOLE_LOAD_BOOL(m_TimeStamps)
+    else if INI_CONSOLE_LOAD_BOOL(m_BatchRendering)
 
 #pragma warning( pop )
 }
@@ -621,8 +1773,14 @@ void ImGuiConsole::SettingsHandler_WriteAll(ImGuiContext *ctx, ImGuiSettingsHand
     if (!handler->UserData)
         return;
 
-    // Get console.
-    auto console = static_cast<ImGuiConsole *>(handler->UserData);
+    // Every view gets its own section.
+    for (ImGuiConsole *console : *static_cast<std::vector<ImGuiConsole *> *>(handler->UserData))
+        console->WriteIniSettings(handler, buf);
+}
+
+void ImGuiConsole::WriteIniSettings(ImGuiSettingsHandler *handler, ImGuiTextBuffer *buf) const
+{
+    const ImGuiConsole *console = this;
 
 #define INI_CONSOLE_SAVE_COLOR(type) buf->appendf(#type"=%i,%i,%i,%i\n", (int)(console->m_ColorPalette[type].x * 255),\
                                                                          (int)(console->m_ColorPalette[type].y * 255),\
@@ -641,6 +1799,7 @@ void ImGuiConsole::SettingsHandler_WriteAll(ImGuiContext *ctx, ImGuiSettingsHand
     INI_CONSOLE_SAVE_BOOL(m_ColoredOutput);
     INI_CONSOLE_SAVE_BOOL(m_FilterBar);
     INI_CONSOLE_SAVE_BOOL(m_TimeStamps);
+    INI_CONSOLE_SAVE_BOOL(m_BatchRendering);
 
     // Window style/visuals
     INI_CONSOLE_SAVE_FLOAT(m_WindowAlpha);
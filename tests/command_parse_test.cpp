@@ -0,0 +1,135 @@
+// Copyright (c) 2020-present, Roland Munguia & Tristan Florian Bouchard.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+// Command line tokenizing and dispatch: commands, set/get and help must parse the same however the line is spaced,
+// and dispatching a set command must not allocate once buffers are warm (Logging it included, the log recycles its text
+// chunks). Also reports dispatch time.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+#include "csys/csys.h"
+
+static size_t s_Allocations = 0;
+
+void *operator new(size_t size)
+{
+    ++s_Allocations;
+    if (void *ptr = std::malloc(size ? size : 1))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept
+{ std::free(ptr); }
+
+void operator delete(void *ptr, size_t) noexcept
+{ std::free(ptr); }
+
+static size_t s_Errors = 0;
+
+static void Check(bool ok, const char *what)
+{
+    if (!ok)
+    {
+        ++s_Errors;
+        std::fprintf(stderr, "failed: %s\n", what);
+    }
+}
+
+int main()
+{
+    csys::System system;
+    system.Logger().SetCapacity(1000);
+
+    float var = 0, color = 0;
+    int hits = 0;
+    std::string text;
+    system.RegisterVariable("var", var, csys::Arg<float>("value"));
+
+    // Name too long for small string optimization, so copying it would allocate.
+    system.RegisterVariable("background_color", color, csys::Arg<float>("value"));
+    system.RegisterCommand("hit", "Add to hits", [&](int count)
+    { hits += count; }, csys::Arg<int>("count"));
+    system.RegisterCommand("say", "Store text", [&](const csys::String &str)
+    { text = str.m_String; }, csys::Arg<csys::String>("text"));
+
+    auto newest = [&]
+    { return std::string(system.Logger().Items().back().Data()); };
+
+    // Text of the items logged by a command line, its own item excluded.
+    auto output = [&](const std::string &line)
+    {
+        system.Logger().Clear();
+        system.RunCommand(line);
+        std::vector<std::string> items;
+        for (size_t i = 1; i < system.Logger().Items().size(); ++i)
+            items.emplace_back(system.Logger().Items()[i].Data());
+        return items;
+    };
+    auto contains = [](const std::vector<std::string> &items, const std::string &text)
+    { return std::find(items.begin(), items.end(), text) != items.end(); };
+
+    // Spacing.
+    system.RunCommand("set var 1.5");
+    Check(var == 1.5f, "set var 1.5");
+    system.RunCommand("  \tset   var \t 2.5  ");
+    Check(var == 2.5f, "set with extra whitespace");
+    system.RunCommand("hit 2");
+    system.RunCommand("hit\t3 ");
+    Check(hits == 5, "command arguments");
+    system.RunCommand("say \"a  b\"");
+    Check(text == "a  b", "quoted string argument");
+
+    // Nested dispatch reuses the parse buffers.
+    system.RegisterCommand("twice", "Run a command twice", [&](const csys::String &cmd)
+    {
+        system.RunCommand(cmd.m_String);
+        system.RunCommand(cmd.m_String);
+    }, csys::Arg<csys::String>("command"));
+    system.RunCommand("twice \"hit 10\"");
+    Check(hits == 25, "nested dispatch");
+
+    // Help lists every command but set/get variables, or a single command.
+    std::vector<std::string> help = output("help");
+    Check(contains(help, "help [command_name:String] (Optional)\n\t\t- Display command(s) information\n\n"), "help lists help");
+    Check(contains(help, "set [variable_name:String] [data]\n\t\t- Assign data to given variable\n\n"), "help lists set");
+    Check(contains(help, "hit [count:Signed_Int]\n\t\t- Add to hits\n\n"), "help lists commands");
+    Check(help.size() == 6, "help skips variables");
+    Check(output("help hit") == std::vector<std::string>{"hit [count:Signed_Int]\n\t\t- Add to hits\n\n\n"}, "help hit");
+    Check(output(" help\t  hit  ") == output("help hit"), "help with extra whitespace");
+
+    // Errors and history.
+    const std::vector<std::string> notFound{"Command doesn't exist and/or variable is not registered\n"};
+    size_t history = system.History().Size();
+    system.RunCommand("   ");
+    Check(system.History().Size() == history, "whitespace only line isn't added to history");
+    Check(output("set") == std::vector<std::string>{"No variable provided\n"}, "set without variable");
+    Check(output("get  ") == std::vector<std::string>{"No variable provided\n"}, "get without variable");
+    Check(output("nope 1") == notFound, "unknown command");
+    Check(output("help nope") == notFound, "help of unknown command");
+    Check(output("set nope 1") == notFound, "set unknown variable");
+    system.RunCommand("get var");
+    Check(newest().find("2.5") != std::string::npos, "get var");
+    Check(system.History()[system.History().Size() - 1] == "get var", "history");
+
+    // No allocation per dispatch once warm.
+    const std::string line = "set background_color 1.0";
+    for (int i = 0; i < 3000; ++i)
+        system.RunCommand(line);
+    size_t before = s_Allocations;
+    auto start = std::chrono::steady_clock::now();
+    const int dispatches = 100000;
+    for (int i = 0; i < dispatches; ++i)
+        system.RunCommand(line);
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / dispatches;
+    size_t allocations = s_Allocations - before;
+    Check(allocations == 0, "set dispatch without allocating");
+
+    std::printf("set dispatch: %.0f ns, %zu allocations over %d dispatches, %zu errors\n", ns, allocations, dispatches, s_Errors);
+    return s_Errors ? 1 : 0;
+}
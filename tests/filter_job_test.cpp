@@ -0,0 +1,94 @@
+// Copyright (c) 2020-present, Roland Munguia & Tristan Florian Bouchard.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+// Background filtering of a large log, while items keep being logged and evicted: once the filter workers are done,
+// the console matches must be exactly the items ImGuiTextFilter passes. Runs ImGui headless, without a backend.
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include "imgui_console.h"
+
+// Exposes filter state.
+class FilterTestConsole : public ImGuiConsole
+{
+public:
+    using ImGuiConsole::ImGuiConsole;
+
+    void Filter(const char *filter)
+    {
+        std::snprintf(m_TextFilter.InputBuf, sizeof(m_TextFilter.InputBuf), "%s", filter);
+        m_TextFilter.Build();
+    }
+
+    [[nodiscard]] bool Filtering() const
+    { return m_FilterJob || !m_FilterRetired.empty(); }
+
+    [[nodiscard]] std::vector<uint64_t> Matches() const
+    { return std::vector<uint64_t>(m_FilterMatches.begin(), m_FilterMatches.end()); }
+
+    [[nodiscard]] const ImGuiTextFilter &TextFilter() const
+    { return m_TextFilter; }
+};
+
+int main()
+{
+    ImGui::CreateContext();
+    ImGuiIO &io = ImGui::GetIO();
+    io.IniFilename = nullptr;
+    io.DisplaySize = ImVec2(800, 600);
+    unsigned char *pixels;
+    int width, height;
+    io.Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);
+
+    size_t errors = 0;
+    for (bool indexed : {false, true})
+    {
+        FilterTestConsole console;
+        csys::ItemLog &log = console.System().Logger();
+        log.SetCapacity(200000);
+        log.EnableSearchIndex(indexed);
+        auto frame = [&]
+        {
+            ImGui::NewFrame();
+            console.Draw();
+            ImGui::Render();
+        };
+
+        // Enough items to be filtered in the background, some of them deferred.
+        for (int i = 0; i < 250000; ++i)
+            console.System().Log(i % 3 ? csys::LOG : csys::WARNING, "{} item {}", i % 3 ? "alpha" : "beta", i);
+        for (int i = 0; i < 1000; ++i)
+            log.Defer(csys::LOG, "alpha deferred {}", i);
+        frame();
+
+        // Filters replaced before their job is done are cancelled.
+        for (const char *filter : {"alpha", "ALPHA,-7", "-beta", "item 12", "deferred,beta", "alp"})
+        {
+            console.Filter(filter);
+            int frames = 0;
+            do
+            {
+                for (int i = 0; i < 500; ++i)
+                    console.System().Log(csys::INFO, "{} late {}", i % 2 ? "alpha" : "gamma", i);
+                frame();
+                ++frames;
+            } while (console.Filtering() && frames < 10000);
+            frame();
+
+            std::vector<uint64_t> expected;
+            for (size_t i = 0; i < log.Items().size(); ++i)
+                if (console.TextFilter().PassFilter(log.Items()[i].View().data(), log.Items()[i].View().data() + log.Items()[i].View().size()))
+                    expected.push_back(log.FirstId() + i);
+
+            std::vector<uint64_t> matches = console.Matches();
+            const bool ok = !console.Filtering() && matches == expected;
+            errors += !ok;
+            std::printf("%s filter \"%s\": %zu matches, %zu expected, %d frames%s\n", indexed ? "indexed" : "scanned", filter,
+                        matches.size(), expected.size(), frames, ok ? "" : " (MISMATCH)");
+        }
+    }
+
+    ImGui::DestroyContext();
+    return errors ? 1 : 0;
+}
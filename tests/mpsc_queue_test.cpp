@@ -0,0 +1,137 @@
+// Copyright (c) 2020-present, Roland Munguia & Tristan Florian Bouchard.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+// Multi-producer stress tests of csys::MpscQueue, and of ItemLog::Post/Drain on top of it: every pushed element must be
+// popped exactly once, in push order per producer, while producers and the consumer run concurrently.
+
+#include <atomic>
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+#include "csys/item.h"
+#include "csys/mpsc_queue.h"
+
+static const uint64_t s_Producers = 8;
+static const uint64_t s_PushesPerProducer = 250000;
+static const uint64_t s_PostsPerProducer = 25000;
+
+static uint64_t QueueStress()
+{
+    csys::MpscQueue<uint64_t> queue;
+    std::atomic<bool> start{false};
+
+    // Elements are (producer << 32 | sequence number).
+    std::vector<std::thread> producers;
+    for (uint64_t producer = 0; producer < s_Producers; ++producer)
+        producers.emplace_back([&queue, &start, producer]
+                               {
+                                   while (!start.load(std::memory_order_acquire))
+                                       std::this_thread::yield();
+                                   for (uint64_t i = 0; i < s_PushesPerProducer; ++i)
+                                       queue.Push(producer << 32 | i);
+                               });
+
+    // Consume while producing.
+    std::vector<uint64_t> next(s_Producers, 0);
+    uint64_t popped = 0, errors = 0;
+    start.store(true, std::memory_order_release);
+    while (popped < s_Producers * s_PushesPerProducer)
+    {
+        uint64_t value;
+        if (!queue.Pop(value))
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        uint64_t producer = value >> 32, sequence = value & 0xffffffff;
+        if (producer >= s_Producers || sequence != next[producer])
+        {
+            if (errors++ < 10)
+                std::fprintf(stderr, "producer %llu: got element %llu, expected %llu\n", (unsigned long long) producer,
+                             (unsigned long long) sequence, (unsigned long long) (producer < s_Producers ? next[producer] : 0));
+            if (producer >= s_Producers)
+                continue;
+        }
+        next[producer] = sequence + 1;
+        ++popped;
+    }
+
+    for (auto &producer : producers)
+        producer.join();
+
+    // Nothing left, nothing duplicated.
+    uint64_t value;
+    if (queue.Pop(value))
+    {
+        std::fprintf(stderr, "queue not empty after every element was popped\n");
+        ++errors;
+    }
+
+    std::printf("queue: %llu elements from %llu producers, %llu errors\n", (unsigned long long) popped, (unsigned long long) s_Producers,
+                (unsigned long long) errors);
+    return errors;
+}
+
+static uint64_t PostStress()
+{
+    csys::ItemLog log;
+    std::atomic<bool> start{false};
+
+    // Item data is "<producer> <sequence number>".
+    std::vector<std::thread> producers;
+    for (uint64_t producer = 0; producer < s_Producers; ++producer)
+        producers.emplace_back([&log, &start, producer]
+                               {
+                                   while (!start.load(std::memory_order_acquire))
+                                       std::this_thread::yield();
+                                   for (uint64_t i = 0; i < s_PostsPerProducer; ++i)
+                                       log.Post(csys::LOG, std::to_string(producer) + " " + std::to_string(i));
+                               });
+
+    // Drain while posting, like the console does every frame.
+    start.store(true, std::memory_order_release);
+    size_t drained = 0;
+    while (drained < s_Producers * s_PostsPerProducer)
+        drained += log.Drain();
+
+    for (auto &producer : producers)
+        producer.join();
+    drained += log.Drain();
+
+    std::vector<uint64_t> next(s_Producers, 0);
+    uint64_t errors = drained != log.Items().size() || drained != s_Producers * s_PostsPerProducer;
+    for (const csys::Item &item : log.Items())
+    {
+        std::string_view data = item.Data();
+        uint64_t producer = s_Producers, sequence = 0;
+        auto space = data.find(' ');
+        if (space != std::string_view::npos)
+        {
+            std::from_chars(data.data(), data.data() + space, producer);
+            std::from_chars(data.data() + space + 1, data.data() + data.size(), sequence);
+        }
+
+        if (producer >= s_Producers || sequence != next[producer])
+        {
+            if (errors++ < 10)
+                std::fprintf(stderr, "unexpected item \"%.*s\"\n", static_cast<int>(data.size()), data.data());
+            continue;
+        }
+        next[producer] = sequence + 1;
+    }
+
+    std::printf("post: %zu items from %llu producers, %llu errors\n", log.Items().size(), (unsigned long long) s_Producers,
+                (unsigned long long) errors);
+    return errors;
+}
+
+int main()
+{
+    uint64_t errors = QueueStress();
+    errors += PostStress();
+    return errors ? 1 : 0;
+}
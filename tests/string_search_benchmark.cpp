@@ -0,0 +1,122 @@
+// Copyright (c) 2020-present, Roland Munguia & Tristan Florian Bouchard.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+// Console filter matching with vectorized search against ImGuiTextFilter::PassFilter, over a generated game log.
+// Usage: string_search_benchmark [lines] [rounds]. Fails if both don't match the same amount of lines.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "csys/string_search.h"
+#include "imgui.h"
+
+// Same rules as ImGuiTextFilter::PassFilter, as the console filters items.
+static bool PassFilter(const ImGuiTextFilter &filter, std::string_view text)
+{
+    bool grep = false;
+    for (const ImGuiTextFilter::ImGuiTextRange &term : filter.Filters)
+    {
+        if (term.empty())
+            continue;
+
+        if (term.b[0] == '-')
+        {
+            if (csys::FindCaseInsensitive(text, std::string_view(term.b + 1, term.e - term.b - 1)) != std::string_view::npos)
+                return false;
+        }
+        else if (csys::FindCaseInsensitive(text, std::string_view(term.b, term.e - term.b)) != std::string_view::npos)
+            return true;
+        else
+            grep = true;
+    }
+    return !grep;
+}
+
+// Log lines of varying length, like a running game logs.
+static std::vector<std::string> MakeLog(size_t lines)
+{
+    static const char *const systems[] = { "Renderer", "Audio", "Physics", "Network", "Assets", "Script", "Input" };
+    static const char *const levels[] = { "INFO", "INFO", "INFO", "LOG", "LOG", "WARNING", "ERROR" };
+    static const char *const events[] = {
+        "Loaded texture 'textures/env/rock_%03u.png' (512x512, %u KB) in %u.%u ms",
+        "Frame %u took %u.%u ms (gpu %u.%u ms)",
+        "Player %u moved to (%u.%u, 12.5, -%u.%u)",
+        "Packet %u dropped, retrying in %u ms",
+        "Compiled shader variant %u of 'shaders/lit_forward.hlsl' with %u.%u ms stall",
+        "Entity %u spawned from prefab 'prefabs/props/barrel_%02u' at sector %u:%u",
+        "Failed to open 'save/slot_%u.dat': file not found (code %u, attempt %u.%u)",
+        "Audio voice %u stolen, %u voices in use, mixer at %u.%u%% load",
+    };
+
+    std::mt19937 rng(42);
+    std::vector<std::string> log(lines);
+    char buffer[512];
+    for (std::string &line : log)
+    {
+        int size = std::snprintf(buffer, sizeof(buffer), "[%02u:%02u:%02u] %-7s %-8s ", unsigned(rng() % 24), unsigned(rng() % 60),
+                                 unsigned(rng() % 60), levels[rng() % 7], systems[rng() % 7]);
+        size += std::snprintf(buffer + size, sizeof(buffer) - size, events[rng() % 8], unsigned(rng() % 1000), unsigned(rng() % 4096),
+                              unsigned(rng() % 100), unsigned(rng() % 10), unsigned(rng() % 10));
+        line.assign(buffer, size);
+
+        // Some stack traces and dumps.
+        if (rng() % 50 == 0)
+            for (unsigned frame = 0, frames = 4 + rng() % 12; frame < frames; ++frame)
+                line += "\n    at Game::Update(float) in src/game/world_" + std::to_string(rng() % 100) + ".cpp";
+    }
+    return log;
+}
+
+int main(int argc, char **argv)
+{
+    const size_t lines = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 200000;
+    const int rounds = argc > 2 ? std::atoi(argv[2]) : 10;
+    const std::vector<std::string> log = MakeLog(lines);
+
+    // Common filters: rare and frequent words, excluding terms, several terms, no match at all.
+    static const char *const filters[] = { "error", "texture", "ROCK_042", "barrel_17,slot_3", "-gpu 1,frame", "-info", "world_99.cpp",
+                                           "no such text in the log" };
+
+    size_t bytes = 0;
+    for (const std::string &line : log)
+        bytes += line.size();
+    std::printf("%zu lines, %.1f MB, best of %d rounds\n\n", log.size(), bytes / (1024.0 * 1024.0), rounds);
+    std::printf("%-26s %9s %12s %12s %8s\n", "filter", "matches", "imgui (ms)", "csys (ms)", "speedup");
+
+    int errors = 0;
+    for (const char *text : filters)
+    {
+        ImGuiTextFilter filter(text);
+
+        double best[2] = { 1e30, 1e30 };
+        size_t matches[2] = {};
+        for (int round = 0; round < rounds; ++round)
+        {
+            for (int method = 0; method < 2; ++method)
+            {
+                auto start = std::chrono::steady_clock::now();
+                size_t count = 0;
+                for (const std::string &line : log)
+                    count += method ? PassFilter(filter, line) : filter.PassFilter(line.data(), line.data() + line.size());
+                std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+                matches[method] = count;
+                best[method] = std::min(best[method], elapsed.count());
+            }
+        }
+
+        std::printf("%-26s %9zu %12.2f %12.2f %7.1fx\n", text, matches[1], best[0], best[1], best[0] / best[1]);
+        if (matches[0] != matches[1])
+        {
+            std::fprintf(stderr, "\"%s\": imgui matched %zu lines, csys %zu\n", text, matches[0], matches[1]);
+            ++errors;
+        }
+    }
+
+    return errors ? 1 : 0;
+}
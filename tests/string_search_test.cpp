@@ -0,0 +1,74 @@
+// Copyright (c) 2020-present, Roland Munguia & Tristan Florian Bouchard.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+// Vectorized substring search against a scalar reference, over random texts crossing every SSE2/AVX2 block boundary.
+// Every text ends where its allocation ends, so reads past it show up under sanitizers.
+
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <string>
+#include <string_view>
+#include "csys/string_search.h"
+
+static size_t ReferenceFind(std::string_view haystack, std::string_view needle, bool ignoreCase)
+{
+    for (size_t pos = 0; pos + needle.size() <= haystack.size(); ++pos)
+    {
+        size_t i = 0;
+        while (i < needle.size() && (ignoreCase ? csys::ToLowerAscii(haystack[pos + i]) == csys::ToLowerAscii(needle[i])
+                                                : haystack[pos + i] == needle[i]))
+            ++i;
+        if (i == needle.size())
+            return pos;
+    }
+    return std::string_view::npos;
+}
+
+int main()
+{
+    // Small alphabet, so partial matches are frequent.
+    static const char alphabet[] = "abAB\n{}";
+    std::mt19937 rng(1234);
+    size_t checks = 0, errors = 0;
+
+    for (size_t size = 0; size <= 160; ++size)
+    {
+        std::unique_ptr<char[]> storage(new char[size + 1]);
+        char *text = storage.get() + 1;
+        for (int round = 0; round < 200; ++round)
+        {
+            for (size_t i = 0; i < size; ++i)
+                text[i] = alphabet[rng() % (sizeof(alphabet) - 1)];
+            std::string_view haystack(text, size);
+
+            // Needle taken from the text (Case flipped half of the time), or random.
+            std::string needle;
+            size_t length = rng() % 40;
+            if (size && rng() % 2)
+            {
+                size_t pos = rng() % size;
+                needle = std::string(haystack.substr(pos, length));
+                if (rng() % 2)
+                    for (char &c : needle)
+                        c = c >= 'a' && c <= 'z' ? static_cast<char>(c - 'a' + 'A') : csys::ToLowerAscii(c);
+            }
+            else
+                for (size_t i = 0; i < length; ++i)
+                    needle.push_back(alphabet[rng() % (sizeof(alphabet) - 1)]);
+
+            for (bool ignoreCase : {false, true})
+            {
+                size_t expected = ReferenceFind(haystack, needle, ignoreCase);
+                size_t found = ignoreCase ? csys::FindCaseInsensitive(haystack, needle) : csys::Find(haystack, needle);
+                ++checks;
+                if (found != expected && errors++ < 10)
+                    std::fprintf(stderr, "%s(\"%.*s\", \"%s\"): got %zu, expected %zu\n", ignoreCase ? "FindCaseInsensitive" : "Find",
+                                 static_cast<int>(size), text, needle.c_str(), found, expected);
+            }
+        }
+    }
+
+    std::printf("%zu searches, %zu errors\n", checks, errors);
+    return errors ? 1 : 0;
+}